@@ -0,0 +1,45 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "change_feed.h"
+
+bool change_feed_sync(change_feed_t *feed, gamma_t *g) {
+    uint64_t version = gamma_version(g), count;
+    if (version == feed->synced) return true;
+    if (!gamma_board_diff(g, feed->synced, NULL, 0, &count)) return false;
+    if (feed->count + count > feed->cap) {
+        uint64_t cap = 2 * (feed->count + count);
+        gamma_change_t *changes = realloc(feed->changes,
+                                          cap * sizeof(gamma_change_t));
+        if (changes == NULL) return false;
+        feed->changes = changes;
+        feed->cap = cap;
+    }
+    gamma_board_diff(g, feed->synced, feed->changes + feed->count, count,
+                     &count);
+    feed->count += count;
+    feed->synced = version;
+    return true;
+}
+
+void change_feed_take(change_feed_t *feed, change_feed_t *taken) {
+    gamma_change_t *changes = taken->changes;
+    uint64_t cap = taken->cap;
+    taken->changes = feed->changes;
+    taken->cap = feed->cap;
+    taken->count = feed->count;
+    feed->changes = changes;
+    feed->cap = cap;
+    feed->count = 0;
+}
+
+void change_feed_free(change_feed_t *feed) {
+    free(feed->changes);
+    feed->changes = NULL;
+    feed->count = 0;
+    feed->cap = 0;
+}
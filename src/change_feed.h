@@ -0,0 +1,48 @@
+/** @file
+ * Interfejs kolejki zmian pól przekazywanych wątkom pracującym w tle
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef CHANGE_FEED_H
+#define CHANGE_FEED_H
+
+#include "gamma.h"
+
+/** @brief Zmiany pól gry pobrane z dziennika zmian (@ref gamma_board_diff),
+ * jeszcze nieodebrane przez wątek, który odtwarza je w swojej kopii gry.
+ */
+struct change_feed {
+    gamma_change_t *changes; ///< zmiany pól w kolejności wykonania
+    uint64_t count; ///< liczba zmian w @p changes
+    uint64_t cap; ///< rozmiar tablicy @p changes
+    uint64_t synced; ///< wersja gry, do której pobrano zmiany
+};
+typedef struct change_feed change_feed_t;
+
+/** @brief Dopisuje do kolejki zmiany pól od wersji @p feed->synced
+ * do bieżącej wersji gry.
+ * @param[in,out] feed – kolejka,
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli dopisano zmiany, a @p false, gdy część
+ * z nich wypadła już z dziennika zmian gry lub nie udało się zaalokować
+ * pamięci.
+ */
+bool change_feed_sync(change_feed_t *feed, gamma_t *g);
+
+/** @brief Odbiera zmiany z kolejki.
+ * Zamienia tablice @p feed i @p taken, więc żadna zmiana nie jest
+ * kopiowana: @p taken dostaje zmiany kolejki, a kolejka – pustą tablicę
+ * @p taken do ponownego użycia. Pole @p synced kolejki się nie zmienia.
+ * @param[in,out] feed  – kolejka,
+ * @param[in,out] taken – odebrane zmiany.
+ */
+void change_feed_take(change_feed_t *feed, change_feed_t *taken);
+
+/** @brief Zwalnia tablicę zmian kolejki.
+ * @param[in,out] feed – kolejka.
+ */
+void change_feed_free(change_feed_t *feed);
+
+#endif /* CHANGE_FEED_H */
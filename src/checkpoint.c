@@ -0,0 +1,354 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "checkpoint.h"
+#include "change_feed.h"
+#include "snapshot.h"
+#include "latency.h"
+#include "varint.h"
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+/** @brief Wątek zapisujący punkty kontrolne.
+ * Wątek ma własną kopię planszy (@p snapshot), którą doprowadza do wersji
+ * zlecenia, odtwarzając zmiany pól z dziennika zmian gry, więc zapisuje
+ * spójny stan, a gra może się w tym czasie zmieniać.
+ */
+typedef struct writer {
+    pthread_t thread; ///< wątek zapisujący
+    pthread_mutex_t lock; ///< chroni pola zlecenia
+    pthread_cond_t wake; ///< sygnalizuje nowe zlecenie lub koniec pracy
+    bool running; ///< czy wątek został uruchomiony
+    bool quit; ///< czy wątek ma zakończyć pracę po ostatnim zleceniu
+    bool failed; ///< czy nie udało się przekazać lub odtworzyć zmian pól
+
+    snapshot_t snapshot; ///< kopia planszy, na której pracuje wątek
+    change_feed_t feed; ///< zmiany pól jeszcze nieodtworzone w kopii
+
+    bool job; ///< czy czeka zlecenie zapisu
+    uint64_t job_line; ///< numer linii wejścia, której dotyczy zlecenie
+} writer_t;
+
+/** Plik, do którego zapisywane są punkty kontrolne, lub NULL.
+ */
+static const char *checkpoint_path = NULL;
+
+/** Co ile ruchów zapisywać punkt kontrolny (0 – bez limitu ruchów).
+ */
+static uint64_t checkpoint_moves = 0;
+
+/** Co ile nanosekund zapisywać punkt kontrolny (0 – bez limitu czasu).
+ */
+static uint64_t checkpoint_ns = 0;
+
+/** Liczba ruchów od ostatniego punktu kontrolnego.
+ */
+static uint64_t checkpoint_count = 0;
+
+/** Chwila zlecenia ostatniego punktu kontrolnego (w nanosekundach).
+ */
+static uint64_t checkpoint_last = 0;
+
+/** Wątek zapisujący punkty kontrolne.
+ */
+static writer_t writer;
+
+/** @brief Seria pól tego samego gracza w zapisie planszy.
+ */
+typedef struct run {
+    uint32_t owner; ///< gracz na polach serii lub 0
+    uint64_t length; ///< liczba pól serii
+} run_t;
+
+/* @brief Dopisuje pole do serii, a gdy pole do niej nie należy, zapisuje
+ * serię i zaczyna nową.
+ * @param[in] out      – strumień,
+ * @param[in,out] run  – bieżąca seria,
+ * @param[in] owner    – gracz na kolejnym polu lub 0.
+ */
+static void run_put(FILE *out, run_t *run, uint32_t owner) {
+    if (run->length > 0 && run->owner != owner) {
+        varint_put(out, run->owner);
+        varint_put(out, run->length);
+        run->length = 0;
+    }
+    run->owner = owner;
+    run->length++;
+}
+
+/* @brief Zapisuje nagłówek punktu kontrolnego.
+ * @param[in] out     – strumień,
+ * @param[in] params  – parametry gry,
+ * @param[in] line    – numer ostatniej wykonanej linii wejścia.
+ */
+static void put_header(FILE *out, const gamma_params_t *params,
+                       uint64_t line) {
+    fwrite(CHECKPOINT_MAGIC, 1, CHECKPOINT_MAGIC_LENGTH, out);
+    varint_put(out, params->width);
+    varint_put(out, params->height);
+    varint_put(out, params->players);
+    varint_put(out, params->areas);
+    varint_put(out, line);
+}
+
+/* @brief Zapisuje ostatnią serię pól, graczy, którzy wykonali złoty ruch,
+ * i znak końca punktu kontrolnego.
+ * @param[in] out     – strumień,
+ * @param[in] run     – ostatnia seria,
+ * @param[in] golden  – gracze, którzy wykonali złoty ruch,
+ * @param[in] count   – liczba graczy w @p golden.
+ * @return Wartość @p true, jeśli zapis się powiódł,
+ * a @p false w przeciwnym razie.
+ */
+static bool put_footer(FILE *out, const run_t *run, const uint32_t *golden,
+                       uint32_t count) {
+    varint_put(out, run->owner);
+    varint_put(out, run->length);
+    varint_put(out, count);
+    for (uint32_t i = 0; i < count; i++) varint_put(out, golden[i]);
+    putc('E', out);
+    return !ferror(out);
+}
+
+bool checkpoint_write(gamma_t *g, uint64_t line, FILE *out) {
+    if (g == NULL || out == NULL) return false;
+    uint32_t count = gamma_golden_players(g, NULL, 0);
+    uint32_t *golden = malloc((count + 1) * sizeof(uint32_t));
+    if (golden == NULL) return false;
+    gamma_golden_players(g, golden, count);
+
+    gamma_params_t params = {g->width, g->height, g->players, g->areas};
+    put_header(out, &params, line);
+    run_t run = {0, 0};
+    for (uint32_t y = 0; y < g->height; y++)
+        for (uint32_t x = 0; x < g->width; x++)
+            run_put(out, &run, gamma_owner(g, x, y));
+    bool written = put_footer(out, &run, golden, count);
+    free(golden);
+    return written;
+}
+
+gamma_t *checkpoint_read(FILE *in, uint64_t *line) {
+    char magic[CHECKPOINT_MAGIC_LENGTH];
+    gamma_params_t params;
+    snapshot_t s;
+    if (in == NULL || line == NULL
+        || fread(magic, 1, CHECKPOINT_MAGIC_LENGTH, in)
+           != CHECKPOINT_MAGIC_LENGTH
+        || memcmp(magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LENGTH) != 0
+        || !varint_get32(in, &params.width)
+        || !varint_get32(in, &params.height)
+        || !varint_get32(in, &params.players)
+        || !varint_get32(in, &params.areas) || !varint_get(in, line)
+        || !snapshot_init(&s, &params))
+        return NULL;
+
+    uint64_t cells = (uint64_t) params.width * params.height;
+    bool valid = true;
+    for (uint64_t done = 0; valid && done < cells; ) {
+        uint32_t owner;
+        uint64_t run = 0;
+        valid = varint_get32(in, &owner) && varint_get(in, &run)
+                && run > 0 && run <= cells - done;
+        for (uint64_t i = 0; valid && i < run; i++) s.owners[done + i] = owner;
+        done += run;
+    }
+
+    uint32_t count;
+    valid = valid && varint_get32(in, &count) && count <= params.players
+            && (s.golden = malloc((count + 1) * sizeof(uint32_t))) != NULL;
+    if (valid) s.golden_count = s.golden_cap = count;
+    for (uint32_t i = 0; valid && i < count; i++)
+        valid = varint_get32(in, &s.golden[i]);
+    gamma_t *g = valid && getc(in) == 'E' ? snapshot_game(&s) : NULL;
+    snapshot_free(&s);
+    return g;
+}
+
+gamma_t *checkpoint_load(const char *path, uint64_t *line) {
+    FILE *in = fopen(path, "rb");
+    if (in == NULL) return NULL;
+    setvbuf(in, NULL, _IOFBF, CHECKPOINT_BUFFER);
+    gamma_t *g = checkpoint_read(in, line);
+    fclose(in);
+    return g;
+}
+
+/* @brief Zapisuje kopię planszy w formacie @ref checkpoint_write.
+ * @param[in] s       – kopia planszy,
+ * @param[in] line    – numer ostatniej wykonanej linii wejścia,
+ * @param[in] out     – strumień.
+ * @return Wartość @p true, jeśli zapis się powiódł,
+ * a @p false w przeciwnym razie.
+ */
+static bool snapshot_write(const snapshot_t *s, uint64_t line, FILE *out) {
+    put_header(out, &s->params, line);
+    run_t run = {0, 0};
+    uint64_t cells = (uint64_t) s->params.width * s->params.height;
+    for (uint64_t i = 0; i < cells; i++) run_put(out, &run, s->owners[i]);
+    return put_footer(out, &run, s->golden, s->golden_count);
+}
+
+/* @brief Zapisuje kopię planszy do pliku punktu kontrolnego.
+ * Zapisuje do pliku tymczasowego, utrwala go na dysku i dopiero wtedy
+ * zastępuje nim plik @ref checkpoint_path, więc plik zawsze zawiera pełny
+ * punkt kontrolny.
+ * @param[in] s       – kopia planszy,
+ * @param[in] line    – numer ostatniej wykonanej linii wejścia.
+ * @return Wartość @p true, jeśli zapis się powiódł,
+ * a @p false w przeciwnym razie.
+ */
+static bool snapshot_save(const snapshot_t *s, uint64_t line) {
+    size_t length = strlen(checkpoint_path);
+    char *temporary = malloc(length + sizeof(".tmp"));
+    if (temporary == NULL) return false;
+    memcpy(temporary, checkpoint_path, length);
+    memcpy(temporary + length, ".tmp", sizeof(".tmp"));
+
+    FILE *out = fopen(temporary, "wb");
+    bool saved = out != NULL;
+    if (saved) {
+        setvbuf(out, NULL, _IOFBF, CHECKPOINT_BUFFER);
+        saved = snapshot_write(s, line, out) && fflush(out) == 0
+                && fsync(fileno(out)) == 0;
+        saved = fclose(out) == 0 && saved;
+    }
+    //stary punkt kontrolny jest zastępowany dopiero pełnym nowym
+    saved = saved && rename(temporary, checkpoint_path) == 0;
+    if (!saved) remove(temporary);
+    free(temporary);
+    return saved;
+}
+
+/* @brief Pętla wątku zapisującego.
+ * Czeka na zlecenie, odtwarza w kopii planszy przekazane zmiany pól
+ * i zapisuje punkt kontrolny. Przed zakończeniem pracy wykonuje
+ * oczekujące zlecenie.
+ * @param[in,out] arg – wątek (writer_t).
+ * @return Wartość NULL.
+ */
+static void *writer_main(void *arg) {
+    writer_t *w = arg;
+    change_feed_t changes = {NULL, 0, 0, 0};
+
+    pthread_mutex_lock(&w->lock);
+    while (true) {
+        while (!w->job && !w->quit) pthread_cond_wait(&w->wake, &w->lock);
+        if (!w->job) break;
+
+        change_feed_take(&w->feed, &changes);
+        uint64_t line = w->job_line;
+        w->job = false;
+        pthread_mutex_unlock(&w->lock);
+
+        bool applied = true;
+        for (uint64_t i = 0; i < changes.count && applied; i++)
+            applied = snapshot_set(&w->snapshot, changes.changes[i].x,
+                                   changes.changes[i].y,
+                                   changes.changes[i].player);
+        if (applied) snapshot_save(&w->snapshot, line);
+
+        pthread_mutex_lock(&w->lock);
+        if (!applied) {
+            w->failed = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&w->lock);
+    change_feed_free(&changes);
+    return NULL;
+}
+
+/* @brief Kończy wątek zapisujący po wykonaniu oczekującego zlecenia
+ * i zwalnia jego zasoby. Nic nie robi, jeśli wątek nie został uruchomiony.
+ */
+static void writer_stop(void) {
+    writer_t *w = &writer;
+    if (!w->running) return;
+    pthread_mutex_lock(&w->lock);
+    w->quit = true;
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->wake);
+    snapshot_free(&w->snapshot);
+    change_feed_free(&w->feed);
+    w->running = false;
+}
+
+void checkpoint_start(const char *path, uint64_t moves, uint64_t ns) {
+    checkpoint_path = path;
+    checkpoint_moves = (moves == 0 && ns == 0) ? CHECKPOINT_MOVES_DEFAULT
+                                               : moves;
+    checkpoint_ns = ns;
+    atexit(writer_stop);
+}
+
+void checkpoint_game(gamma_t *g) {
+    if (checkpoint_path == NULL || g == NULL) return;
+    writer_stop();
+    writer_t *w = &writer;
+    memset(w, 0, sizeof(*w));
+    snapshot_t *s = &w->snapshot;
+    gamma_params_t params = {g->width, g->height, g->players, g->areas};
+    bool created = snapshot_init(s, &params);
+    s->golden_count = gamma_golden_players(g, NULL, 0);
+    s->golden_cap = s->golden_count;
+    s->golden = malloc((s->golden_cap + 1) * sizeof(uint32_t));
+    if (!created || s->golden == NULL) {
+        snapshot_free(s);
+        return;
+    }
+    gamma_golden_players(g, s->golden, s->golden_count);
+    //nowa gra ma pustą planszę, więc jej kopii nie trzeba wypełniać
+    if (gamma_version(g) != 0) {
+        for (uint32_t y = 0; y < g->height; y++)
+            for (uint32_t x = 0; x < g->width; x++)
+                s->owners[(uint64_t) y * g->width + x] = gamma_owner(g, x, y);
+    }
+    w->feed.synced = gamma_version(g);
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->wake, NULL);
+    if (pthread_create(&w->thread, NULL, writer_main, w) != 0) {
+        pthread_mutex_destroy(&w->lock);
+        pthread_cond_destroy(&w->wake);
+        snapshot_free(s);
+        return;
+    }
+    w->running = true;
+    checkpoint_count = 0;
+    checkpoint_last = latency_now();
+}
+
+void checkpoint_move(gamma_t *g, uint64_t line) {
+    writer_t *w = &writer;
+    if (!w->running || g == NULL) return;
+    checkpoint_count++;
+    bool due = (checkpoint_moves != 0 && checkpoint_count >= checkpoint_moves)
+               || (checkpoint_ns != 0
+                   && latency_now() - checkpoint_last >= checkpoint_ns);
+    //zmiany przekazywane są, zanim wypadną z dziennika zmian gry
+    if (!due && gamma_version(g) - w->feed.synced < g->changes_size / 2)
+        return;
+
+    pthread_mutex_lock(&w->lock);
+    bool failed = w->failed || !change_feed_sync(&w->feed, g);
+    if (!failed && due) {
+        w->job = true;
+        w->job_line = line;
+        pthread_cond_signal(&w->wake);
+    }
+    pthread_mutex_unlock(&w->lock);
+    if (due) {
+        checkpoint_count = 0;
+        checkpoint_last = latency_now();
+    }
+    if (failed) writer_stop();
+}
@@ -0,0 +1,92 @@
+/** @file
+ * Interfejs punktów kontrolnych gry w trybie wsadowym
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "gamma.h"
+
+/** Znaczniki na początku pliku z punktem kontrolnym, ostatni bajt to wersja
+ * formatu.
+ */
+#define CHECKPOINT_MAGIC "GMCP\001"
+
+/** Długość znacznika @ref CHECKPOINT_MAGIC.
+ */
+#define CHECKPOINT_MAGIC_LENGTH 5
+
+/** Co ile ruchów zapisywany jest punkt kontrolny, jeśli nie podano ani
+ * liczby ruchów, ani czasu.
+ */
+#define CHECKPOINT_MOVES_DEFAULT 1000000
+
+/** Rozmiar bufora zapisu i odczytu punktu kontrolnego.
+ */
+#define CHECKPOINT_BUFFER (1 << 20)
+
+/** @brief Zapisuje stan gry do strumienia.
+ * Po znaczniku @ref CHECKPOINT_MAGIC zapisywane są: szerokość, wysokość,
+ * liczba graczy, liczba obszarów, numer linii @p line, a dalej pola planszy
+ * wierszami od y = 0 jako pary (gracz lub 0, długość serii pól), liczba
+ * graczy, którzy wykonali złoty ruch, ich numery i na końcu znak 'E'.
+ * Wszystkie liczby zapisywane są jako varint.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] line    – numer ostatniej wykonanej linii wejścia,
+ * @param[in] out     – strumień.
+ * @return Wartość @p true, jeśli zapis się powiódł,
+ * a @p false w przeciwnym razie.
+ */
+bool checkpoint_write(gamma_t *g, uint64_t line, FILE *out);
+
+/** @brief Odtwarza grę zapisaną przez @ref checkpoint_write.
+ * @param[in] in      – strumień,
+ * @param[out] line   – numer ostatniej wykonanej linii wejścia.
+ * @return Odtworzona gra lub NULL, jeśli zapis jest niepoprawny
+ * lub nie udało się zaalokować pamięci.
+ */
+gamma_t *checkpoint_read(FILE *in, uint64_t *line);
+
+/** @brief Odtwarza grę z pliku z punktem kontrolnym.
+ * @param[in] path    – ścieżka do pliku,
+ * @param[out] line   – numer ostatniej wykonanej linii wejścia.
+ * @return Odtworzona gra lub NULL, jeśli nie udało się jej odtworzyć.
+ */
+gamma_t *checkpoint_load(const char *path, uint64_t *line);
+
+/** @brief Włącza okresowe zapisywanie punktów kontrolnych.
+ * Punkty kontrolne zapisuje wątek w tle z własnej kopii planszy, więc pętla
+ * poleceń nie czeka na zapis. Plik zapisywany jest najpierw pod nazwą
+ * z przyrostkiem ".tmp", utrwalany na dysku i dopiero wtedy zastępuje
+ * poprzedni punkt kontrolny. Na koniec programu wątek wykonuje oczekujący
+ * zapis i kończy pracę.
+ * @param[in] path    – ścieżka do pliku,
+ * @param[in] moves   – co ile ruchów zapisywać punkt lub 0,
+ * @param[in] ns      – co ile nanosekund zapisywać punkt lub 0;
+ *                      jeśli @p moves i @p ns są równe 0, punkt zapisywany
+ *                      jest co @ref CHECKPOINT_MOVES_DEFAULT ruchów.
+ */
+void checkpoint_start(const char *path, uint64_t moves, uint64_t ns);
+
+/** @brief Zaczyna zapisywanie punktów kontrolnych gry @p g.
+ * Tworzy kopię planszy dla wątku zapisującego (dla nowej gry bez
+ * przepisywania pól). Nic nie robi, jeśli zapisywanie nie jest włączone.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ */
+void checkpoint_game(gamma_t *g);
+
+/** @brief Odnotowuje wykonany (przyjęty) ruch w grze przekazanej
+ * @ref checkpoint_game. Odrzucone ruchy nie są liczone.
+ * Przekazuje wątkowi zapisującemu zmiany pól z dziennika zmian gry, zanim
+ * zostaną w nim nadpisane, a gdy nadszedł czas, zleca zapis punktu
+ * kontrolnego. Koszt to skopiowanie zmian od poprzedniego przekazania.
+ * Nic nie robi, jeśli zapisywanie nie jest włączone.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] line    – numer linii wejścia z wykonanym ruchem.
+ */
+void checkpoint_move(gamma_t *g, uint64_t line);
+
+#endif /* CHECKPOINT_H */
@@ -7,85 +7,59 @@
 
 #include "commands.h"
 
-bool only_spaces(char* buffer, uint64_t index){
-  for(uint64_t i = 0; i < index; i++){
-    if(!isspace(buffer[i]))
-      return false;
-  }
-  return true;
-}
-
-bool good_letter(char letter){
-  if(isspace(letter)) return true;
-  if('0' <= letter && letter <= '9') return true;
-  return false;
-}
-
-/* @brief Sprawdza, czy słowo ma na początk 0
- * @param[in] buffer       – tablica znaków, którą sprawdzamy
- * @return @p true jeśli na początku jest zeru, a @p false w przeciwnym razie.
+/** Liczba zmian planszy pobieranych naraz przez polecenie d.
  */
-bool zero_is_first_digit(char* buffer){
-  for(uint32_t i = 0; i < strlen(buffer); i++){
-    if(isspace(buffer[i])) continue;
-    else if(buffer[i] != '0') return false;
-    else return true;
-  }
-  return false;
-}
+#define DIFF_CHUNK 1024
 
-/* @brief Interpretuje tabilcę char jako argumenty typu uint32_t.
- * @param[in] buffer       – tablica znaków, w której szukamy argumentów
- * @param[in] argc         – oczekiwana liczba argumentów
- * @param[in] argv         – tablica, do wypełnienia argumentami
- * @return @p true jeśli buffer da się zinterpretować jako dokładnie
- * argv argumentów typu uint32_t, a @p false w przeciwnym razie.
+/* @brief Podaje strumień dla wyniku, który może mieć rozmiar planszy.
+ * Utrwala wcześniej dziennik, żeby plansza nie czekała na to w pamięci.
+ * Jeśli utrwalenie się nie powiodło, kończy program z kodem 1.
+ * @param[in] line    – nr linii z poleceniem.
+ * @return Strumień wyników.
  */
-bool complete_arguments(char* buffer, uint32_t argc, uint32_t* argv){
-  if(strlen(buffer) > 1
-  && !isspace(buffer[1])){
-    return false;
-  }
-  (buffer)[0] = ' ';
-
-  int64_t arg;
-  for(uint32_t i = 0; i < argc; i++){
-    if(strlen(buffer) == 0){
-      return false;
-    }
-    if(zero_is_first_digit(buffer)){
-      arg = strtoul(buffer, &buffer, 10);
-      if(arg < 0 || arg > UINT32_MAX) return false;
-    }
-    else{
-      arg = strtoul(buffer, &buffer, 10);
-      if(arg <= 0 || arg > UINT32_MAX) return false;
-    }
-    argv[i] = (uint32_t)arg;
+static FILE *board_output(uint64_t line){
+  if(!wal_flush()){
+    fprintf(stderr, "ERROR %lu\n", line);
+    exit(1);
   }
-  if(!only_spaces(buffer, strlen(buffer))) return false;
-
-  return true;
+  return wal_output();
 }
 
-void try_command_I(gamma_t **g, char* buffer, uint32_t* argv, uint64_t line){
-  if(complete_arguments(buffer, 4, argv)
-  && (*g = gamma_new(argv[0], argv[1], argv[2], argv[3])) != NULL){
+void try_command_I(char* buffer, int32_t argc, uint32_t* argv, uint64_t line){
+  gamma_t *g;
+  if(argc == 4
+  && (g = gamma_new(argv[0], argv[1], argv[2], argv[3])) != NULL){
     printf("OK %lu\n", line);
+    trace_game(g);
     if(argv != NULL) free(argv);
     if(buffer != NULL) free(buffer);
-    interactive_mode(*g);
+    interactive_mode(g);
   }
   else{
     fprintf(stderr, "ERROR %lu\n", line);
   }
 }
 
-void try_command_B(gamma_t **g, char* buffer, uint32_t* argv,
+void try_command_B(gamma_engine_t **g, const gamma_backend_t *backend,
+                   int32_t argc, uint32_t* argv,
                    uint64_t line, bool *batch_mode){
-  if(complete_arguments(buffer, 4, argv)
-  && (*g = gamma_new(argv[0], argv[1], argv[2], argv[3])) != NULL){
-    printf("OK %lu\n", line);
+  gamma_params_t params;
+  if(argc == 4){
+    params.width = argv[0];
+    params.height = argv[1];
+    params.players = argv[2];
+    params.areas = argv[3];
+    *g = gamma_new_ex(&params, backend);
+  }
+  if(*g != NULL){
+    //gra, której nie udało się zapisać w dzienniku, nie jest rozpoczynana
+    if(!wal_game(gamma_engine_dense(*g), line)){
+      fprintf(stderr, "ERROR %lu\n", line);
+      exit(1);
+    }
+    fprintf(wal_output(), "OK %lu\n", line);
+    trace_game(gamma_engine_dense(*g));
+    checkpoint_game(gamma_engine_dense(*g));
     *batch_mode = true;
   }
   else{
@@ -93,58 +67,158 @@ void try_command_B(gamma_t **g, char* buffer, uint32_t* argv,
   }
 }
 
-void try_command_m(gamma_t *g, char* buffer, uint32_t* argv, uint64_t line){
-  if(complete_arguments(buffer, 3, argv)){
-    if(gamma_move(g, argv[0], argv[1], argv[2])) printf("1\n");
-    else printf("0\n");
+/* @brief Wykonuje ruch. Jeśli grę prowadzi gamma_t, zapisuje go w śladzie,
+ * wykonany ruch zapisuje w dzienniku i w razie potrzeby zapisuje punkt
+ * kontrolny. Jeśli nie udało się zapisać ruchu w dzienniku, kończy program
+ * z kodem 1, zanim wynik ruchu zostanie wypisany.
+ * @param[in,out] g   – gra,
+ * @param[in] golden  – czy ruch jest złotym ruchem,
+ * @param[in] argv    – numer gracza, numer kolumny i numer wiersza,
+ * @param[in] line    – nr linii z ruchem.
+ * @return Wynik ruchu.
+ */
+static bool engine_move(gamma_engine_t *g, bool golden, const uint32_t *argv,
+                        uint64_t line){
+  gamma_t *dense = gamma_engine_dense(g);
+  if(dense != NULL){
+    bool moved = golden ? trace_golden_move(dense, argv[0], argv[1], argv[2])
+                        : trace_move(dense, argv[0], argv[1], argv[2]);
+    if(moved && !wal_move(golden, argv[0], argv[1], argv[2], line)){
+      fprintf(stderr, "ERROR %lu\n", line);
+      exit(1);
+    }
+    if(moved) checkpoint_move(dense, line);
+    return moved;
+  }
+  if(golden)
+    return g->backend->golden_move(g->game, argv[0], argv[1], argv[2]);
+  return g->backend->move(g->game, argv[0], argv[1], argv[2]);
+}
+
+void try_command_m(gamma_engine_t *g, int32_t argc, uint32_t* argv,
+                   uint64_t line){
+  if(argc == 3){
+    if(engine_move(g, false, argv, line)) fprintf(wal_output(), "1\n");
+    else fprintf(wal_output(), "0\n");
   }
   else{
     fprintf(stderr, "ERROR %lu\n", line);
   }
 }
 
-void try_command_g(gamma_t *g, char* buffer, uint32_t* argv, uint64_t line){
-  if(complete_arguments(buffer, 3, argv)){
-    if(gamma_golden_move(g, argv[0], argv[1], argv[2])) printf("1\n");
-    else printf("0\n");
+void try_command_g(gamma_engine_t *g, int32_t argc, uint32_t* argv,
+                   uint64_t line){
+  if(argc == 3){
+    if(engine_move(g, true, argv, line)) fprintf(wal_output(), "1\n");
+    else fprintf(wal_output(), "0\n");
   }
   else{
     fprintf(stderr, "ERROR %lu\n", line);
   }
 }
 
-void try_command_b(gamma_t *g, char* buffer, uint32_t* argv, uint64_t line){
-  if(complete_arguments(buffer, 1, argv))
-    printf("%lu\n", gamma_busy_fields(g, argv[0]));
+void try_command_b(gamma_engine_t *g, int32_t argc, uint32_t* argv,
+                   uint64_t line){
+  if(argc == 1)
+    fprintf(wal_output(), "%lu\n", g->backend->busy_fields(g->game, argv[0]));
   else
     fprintf(stderr, "ERROR %lu\n", line);
 }
 
-void try_command_f(gamma_t *g, char* buffer, uint32_t* argv, uint64_t line){
-  if(complete_arguments(buffer, 1, argv))
-    printf("%lu\n", gamma_free_fields(g, argv[0]));
+void try_command_f(gamma_engine_t *g, int32_t argc, uint32_t* argv,
+                   uint64_t line){
+  if(argc == 1)
+    fprintf(wal_output(), "%lu\n", g->backend->free_fields(g->game, argv[0]));
   else
     fprintf(stderr, "ERROR %lu\n", line);
 }
 
-void try_command_q(gamma_t *g, char* buffer, uint32_t* argv, uint64_t line){
-  if(complete_arguments(buffer, 1, argv))
-    printf("%u\n", gamma_golden_possible(g, argv[0]));
+void try_command_q(gamma_engine_t *g, int32_t argc, uint32_t* argv,
+                   uint64_t line){
+  if(argc == 1)
+    fprintf(wal_output(), "%u\n",
+            g->backend->golden_possible(g->game, argv[0]));
   else
     fprintf(stderr, "ERROR %lu\n", line);
 }
 
-void try_command_p(gamma_t *g, char* buffer, uint32_t* argv, uint64_t line){
-  if(!complete_arguments(buffer, 0, argv)){
+void try_command_p(gamma_engine_t *g, int32_t argc, uint64_t line){
+  if(argc != 0){
     fprintf(stderr, "ERROR %lu\n", line);
     return;
   }
-  char* board = gamma_board(g);
-  if(g == NULL){
+  if(!g->backend->board_write(g->game, board_output(line))){
     fprintf(stderr, "ERROR %lu\n", line);
   }
-  else{
-    printf("%s", board);
-    free(board);
+}
+
+void try_command_r(gamma_engine_t *engine, int32_t argc, uint32_t* argv,
+                   uint64_t line){
+  gamma_t *g = gamma_engine_dense(engine);
+  if(argc == 5 && g != NULL)
+    fprintf(wal_output(), "%lu\n",
+            gamma_rect_count(g, argv[0], argv[1], argv[2], argv[3], argv[4]));
+  else
+    fprintf(stderr, "ERROR %lu\n", line);
+}
+
+void try_command_P(gamma_engine_t *g, int32_t argc, uint64_t line){
+  if(argc != 0
+  || !gamma_board_rle_write(gamma_engine_dense(g), board_output(line))){
+    fprintf(stderr, "ERROR %lu\n", line);
   }
 }
+
+void try_command_d(gamma_engine_t *engine, int32_t argc, uint32_t* argv,
+                   uint64_t line){
+  gamma_t *g = gamma_engine_dense(engine);
+  uint64_t count;
+  if(argc != 1 || g == NULL){
+    fprintf(stderr, "ERROR %lu\n", line);
+    return;
+  }
+  FILE *out = board_output(line);
+  if(!gamma_board_diff(g, argv[0], NULL, 0, &count)){
+    fprintf(out, "F %lu\n", gamma_version(g));
+    gamma_board_write(g, out);
+    return;
+  }
+  fprintf(out, "D %lu %lu\n", gamma_version(g), count);
+  gamma_change_t changes[DIFF_CHUNK];
+  for(uint64_t done = 0; done < count; ){
+    uint64_t left;
+    gamma_board_diff(g, argv[0] + done, changes, DIFF_CHUNK, &left);
+    for(uint64_t i = 0; i < left && i < DIFF_CHUNK; i++, done++)
+      fprintf(out, "%u %u %u\n",
+              changes[i].x, changes[i].y, changes[i].player);
+  }
+}
+
+void try_command_s(gamma_engine_t *g, int32_t argc, uint64_t line){
+  gamma_stats_t stats;
+  if(argc != 0
+  || !gamma_stats(gamma_engine_dense(g), &stats)){
+    fprintf(stderr, "ERROR %lu\n", line);
+    return;
+  }
+  FILE *out = wal_output();
+  fprintf(out, "moves %lu %lu\n", stats.moves, stats.moves_accepted);
+  fprintf(out, "golden_moves %lu %lu\n",
+          stats.golden_moves, stats.golden_moves_accepted);
+  fprintf(out, "block_steps %lu\n", stats.block_steps);
+  fprintf(out, "block_evert_cells %lu\n", stats.block_evert_cells);
+  fprintf(out, "fu_recreate_cells %lu\n", stats.fu_recreate_cells);
+  fprintf(out, "fu_find %lu %lu %lu\n", stats.fu_find_calls,
+          stats.fu_find_depth, stats.fu_find_depth_max);
+  fprintf(out, "golden_possible %lu %lu %lu\n", stats.golden_possible_calls,
+          stats.golden_possible_cells, stats.golden_possible_cells_max);
+  fprintf(out, "new_areas %lu %lu\n",
+          stats.new_areas_calls, stats.new_areas_local);
+}
+
+void try_command_l(const latency_t *latency, int32_t argc, uint64_t line){
+  if(argc == 0)
+    latency_print(latency, stderr);
+  else
+    fprintf(stderr, "ERROR %lu\n", line);
+}
@@ -10,90 +10,137 @@
 
 #include "gamma.h"
 #include "interactive.h"
+#include "latency.h"
+#include "trace.h"
+#include "checkpoint.h"
+#include "wal.h"
+#include "parse.h"
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <stdint.h>
 
-/** @brief Sprawdza, czy znak to cyfra lub biały znak
- * @param[in] letter       – znak do analizy
- * @return @p true jeśli znak to cyfra lub biały znak,
- * a @p false w przeciwnym razie.
- */
-bool good_letter(char letter);
-
-/** @brief Sprawdza, czy słowo składa się z samych białych znaków
- * @param[in] buffer       – tablica znaków, którą sprawdzamy
- * @param[in] index        – wypełniona część słowa
- * @return @p true jeśli na początku jest zeru, a @p false w przeciwnym razie.
- */
-bool only_spaces(char *buffer, uint64_t index);
-
 /** @brief Wywołuje gamma_new i w wypadku powodzenia przechodzi do interac mode.
- * @param[in] g          – wskaźnik na strukturę przechowującą stan gry.
- * @param[in] buffer     – tablica znaków, w której szukamy argumentów,
- * @param[in] argv       – tablica, do wypełniona argumentami,
+ * Przed przejściem do interac mode zwalnia @p buffer i @p argv.
+ * @param[in] buffer     – bufor linii polecenia,
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
+ * @param[in] argv       – tablica, wypełniona argumentami,
  * @param[in] line       – nr ostatniej linii.
  */
-void try_command_I(gamma_t **g, char *buffer, uint32_t *argv, uint64_t line);
+void try_command_I(char *buffer, int32_t argc, uint32_t *argv, uint64_t line);
 
-/** @brief Wywołuje gamma_new i w wypadku powodzenia przechodzi do batch mode.
- * @param[in] g          – wskaźnik na strukturę przechowującą stan gry.
- * @param[in] buffer     – tablica znaków, w której szukamy argumentów,
- * @param[in] argv       – tablica, do wypełniona argumentami,
+/** @brief Wywołuje gamma_new_ex i w wypadku powodzenia przechodzi do batch mode.
+ * Tylko gry prowadzone przez silnik gamma_t zapisywane są w śladzie
+ * i obsługują polecenia d oraz s.
+ * @param[out] g         – gra,
+ * @param[in] backend    – silnik lub NULL, jeśli ma zostać wybrany
+ *                         automatycznie,
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
+ * @param[in] argv       – tablica, wypełniona argumentami,
  * @param[in] line       – nr ostatniej linii,
  * @param[in] batch_mode – zmienna oznaczająca czy batch mode jest aktywny.
  */
-void try_command_B(gamma_t **g, char *buffer, uint32_t *argv,
+void try_command_B(gamma_engine_t **g, const gamma_backend_t *backend,
+                   int32_t argc, uint32_t *argv,
                    uint64_t line, bool *batch_mode);
 
 
 /** @brief Wywołuje gamma_move.
- * @param[in] g          – wskaźnik na strukturę przechowującą stan gry.
- * @param[in] buffer     – tablica znaków, w której szukamy argumentów,
+ * @param[in] g          – gra.
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
  * @param[in] argv       – tablica, wypełniona argumentami,
  * @param[in] line       – nr ostatniej linii.
  */
-void try_command_m(gamma_t *g, char *buffer, uint32_t *argv, uint64_t line);
+void try_command_m(gamma_engine_t *g, int32_t argc, uint32_t *argv,
+                   uint64_t line);
 
 /** @brief Wywołuje gamma_golden_move.
- * @param[in] g          – wskaźnik na strukturę przechowującą stan gry.
- * @param[in] buffer     – tablica znaków, w której szukamy argumentów,
+ * @param[in] g          – gra.
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
  * @param[in] argv       – tablica, wypełniona argumentami,
  * @param[in] line       – nr ostatniej linii.
  */
-void try_command_g(gamma_t *g, char *buffer, uint32_t *argv, uint64_t line);
+void try_command_g(gamma_engine_t *g, int32_t argc, uint32_t *argv,
+                   uint64_t line);
 
 /** @brief Wywołuje gamma_busy_fields.
- * @param[in] g          – wskaźnik na strukturę przechowującą stan gry.
- * @param[in] buffer     – tablica znaków, w której szukamy argumentów,
+ * @param[in] g          – gra.
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
  * @param[in] argv       – tablica, wypełniona argumentami,
  * @param[in] line       – nr ostatniej linii.
  */
-void try_command_b(gamma_t *g, char *buffer, uint32_t *argv, uint64_t line);
+void try_command_b(gamma_engine_t *g, int32_t argc, uint32_t *argv,
+                   uint64_t line);
 
 /** @brief Wywołuje gamma_free_fields.
- * @param[in] g          – wskaźnik na strukturę przechowującą stan gry.
- * @param[in] buffer     – tablica znaków, w której szukamy argumentów,
+ * @param[in] g          – gra.
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
  * @param[in] argv       – tablica, wypełniona argumentami,
  * @param[in] line       – nr ostatniej linii.
  */
-void try_command_f(gamma_t *g, char *buffer, uint32_t *argv, uint64_t line);
+void try_command_f(gamma_engine_t *g, int32_t argc, uint32_t *argv,
+                   uint64_t line);
 
 /** @brief Wywołuje gamma_golden_possible.
- * @param[in] g          – wskaźnik na strukturę przechowującą stan gry.
- * @param[in] buffer     – tablica znaków, w której szukamy argumentów,
+ * @param[in] g          – gra.
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
+ * @param[in] argv       – tablica, wypełniona argumentami,
+ * @param[in] line       – nr ostatniej linii.
+ */
+void try_command_q(gamma_engine_t *g, int32_t argc, uint32_t *argv,
+                   uint64_t line);
+
+/** @brief Wypisuje planszę za pomocą gamma_board_write.
+ * @param[in] g          – gra.
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
+ * @param[in] line       – nr ostatniej linii.
+ */
+void try_command_p(gamma_engine_t *g, int32_t argc, uint64_t line);
+
+/** @brief Wywołuje gamma_rect_count.
+ * Argumenty to numer gracza (0 dla wolnych pól) oraz x0, y0, x1 i y1.
+ * Działa tylko dla gier prowadzonych przez silnik gamma_t.
+ * @param[in] g          – gra.
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
  * @param[in] argv       – tablica, wypełniona argumentami,
  * @param[in] line       – nr ostatniej linii.
  */
-void try_command_q(gamma_t *g, char *buffer, uint32_t *argv, uint64_t line);
+void try_command_r(gamma_engine_t *g, int32_t argc, uint32_t *argv,
+                   uint64_t line);
+
+/** @brief Wypisuje planszę jako serie pól za pomocą gamma_board_rle_write.
+ * Działa tylko dla gier prowadzonych przez silnik gamma_t.
+ * @param[in] g          – gra.
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
+ * @param[in] line       – nr ostatniej linii.
+ */
+void try_command_P(gamma_engine_t *g, int32_t argc, uint64_t line);
 
-/** @brief Wywołuje gamma_board i wypisuje zaalokowany bufor.
- * @param[in] g          – wskaźnik na strukturę przechowującą stan gry.
- * @param[in] buffer     – tablica znaków, w której szukamy argumentów,
+/** @brief Wypisuje zmiany planszy od podanej wersji gry.
+ * Jeśli gamma_board_diff podaje zmiany od wersji z argumentu, wypisuje linię
+ * "D <wersja> <liczba zmian>", a po niej zmiany w postaci "x y gracz".
+ * W przeciwnym razie wypisuje linię "F <wersja>", a po niej całą planszę.
+ * @param[in] g          – gra.
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
  * @param[in] argv       – tablica, wypełniona argumentami,
  * @param[in] line       – nr ostatniej linii.
  */
-void try_command_p(gamma_t *g, char *buffer, uint32_t *argv, uint64_t line);
+void try_command_d(gamma_engine_t *g, int32_t argc, uint32_t *argv,
+                   uint64_t line);
+
+/** @brief Wywołuje gamma_stats i wypisuje liczniki operacji silnika.
+ * Każdy licznik wypisywany jest w osobnej linii jako nazwa i wartość.
+ * @param[in] g          – gra.
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
+ * @param[in] line       – nr ostatniej linii.
+ */
+void try_command_s(gamma_engine_t *g, int32_t argc, uint64_t line);
+
+/** @brief Wypisuje na wyjście diagnostyczne histogramy czasów poleceń.
+ * @param[in] latency    – histogramy czasów wykonania poleceń,
+ * @param[in] argc       – liczba argumentów lub -1 dla niepoprawnej linii,
+ * @param[in] line       – nr ostatniej linii.
+ */
+void try_command_l(const latency_t *latency, int32_t argc, uint64_t line);
 
 #endif /* COMMANDS_H */
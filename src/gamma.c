@@ -6,6 +6,80 @@
  */
 
 #include "gamma.h"
+#include <string.h>
+
+/** Najdłuższy opis pola planszy: numer gracza (10 cyfr) otoczony spacjami. */
+#define BOARD_CELL_MAX 12
+
+uint32_t board_cell_length(uint32_t player);
+
+/** Największa liczba zmian pamiętanych w dzienniku zmian planszy. */
+#define GAMMA_CHANGE_LOG_MAX (1 << 16)
+
+/** Największa liczba pól prostokąta, który @ref gamma_rect_count liczy
+ * bezpośrednio na planszy, bez drzewa Fenwicka. */
+#define RECT_SCAN_MAX 4096
+
+/** Liczba grup sąsiadów pola, które łączą się w pierścieniu 3x3 wokół niego,
+ * dla każdego układu pól pierścienia zajętych przez właściciela pola
+ * (@ref ring_mask). Sąsiadów bezpośrednich jednej grupy łączą pola
+ * pierścienia, więc po zdjęciu pionka z pola pozostaną w jednym obszarze.
+ * Wygenerowane przez połączenie kolejnych zajętych pól pierścienia
+ * i policzenie spójnych fragmentów zawierających sąsiada bezpośredniego. */
+static const uint8_t RING_GROUPS[256] = {
+  0, 1, 0, 1, 1, 2, 1, 1, 0, 1, 0, 1, 1, 2, 1, 1,
+  1, 2, 1, 2, 2, 3, 2, 2, 1, 2, 1, 2, 1, 2, 1, 1,
+  0, 1, 0, 1, 1, 2, 1, 1, 0, 1, 0, 1, 1, 2, 1, 1,
+  1, 2, 1, 2, 2, 3, 2, 2, 1, 2, 1, 2, 1, 2, 1, 1,
+  1, 2, 1, 2, 2, 3, 2, 2, 1, 2, 1, 2, 2, 3, 2, 2,
+  2, 3, 2, 3, 3, 4, 3, 3, 2, 3, 2, 3, 2, 3, 2, 2,
+  1, 2, 1, 2, 2, 3, 2, 2, 1, 2, 1, 2, 2, 3, 2, 2,
+  1, 2, 1, 2, 2, 3, 2, 2, 1, 2, 1, 2, 1, 2, 1, 1,
+  0, 1, 0, 1, 1, 2, 1, 1, 0, 1, 0, 1, 1, 2, 1, 1,
+  1, 2, 1, 2, 2, 3, 2, 2, 1, 2, 1, 2, 1, 2, 1, 1,
+  0, 1, 0, 1, 1, 2, 1, 1, 0, 1, 0, 1, 1, 2, 1, 1,
+  1, 2, 1, 2, 2, 3, 2, 2, 1, 2, 1, 2, 1, 2, 1, 1,
+  1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 2, 2, 2, 1,
+  2, 2, 2, 2, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2, 1,
+  1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 2, 2, 2, 1,
+  1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+};
+
+/** Mnożnik funkcji haszującej numery graczy (złoty podział 2^32). */
+#define PLAYER_HASH 2654435769u
+
+/** Początkowa liczba stanów graczy, na które jest miejsce. */
+#define PLAYERS_INITIAL 4
+
+/** Indeks, którego nie ma żadne pole – używany przy odtwarzaniu tablicy
+ * ojcostwa. */
+#define FU_NONE UINT64_MAX
+
+/** Znacznik reprezentanta bloku w strukturze find and union bloków –
+ * pozostałe bity wpisu reprezentanta to indeks najwyższego pola bloku. */
+#define BLOCK_HEAD (UINT64_C(1) << 63)
+
+/** Rozmiar fragmentu, w jakim plansza jest wypisywana przez
+ * @ref gamma_board_write. */
+#define BOARD_CHUNK (1 << 16)
+
+/** Największa długość opisu serii pól w @ref gamma_board_rle_write
+ * (numer gracza, '*', długość serii i znak za serią). */
+#define BOARD_RUN_MAX 32
+
+/** Liczba pól porównywanych naraz przy szukaniu końca serii pól. */
+#define BOARD_RUN_BLOCK 16
+
+#ifdef GAMMA_STATS
+/** Zwiększa licznik @p field gry @p g o @p n. */
+#define STATS_ADD(g, field, n) ((g)->stats.field += (n))
+/** Ustawia licznik @p field gry @p g na @p n, jeśli @p n jest większe. */
+#define STATS_MAX(g, field, n) \
+  do{ if((g)->stats.field < (n)) (g)->stats.field = (n); }while(0)
+#else
+#define STATS_ADD(g, field, n) ((void)0)
+#define STATS_MAX(g, field, n) ((void)0)
+#endif
 
 /* @brief tworzy zmienną typu pair_t o zadanych elementach pary
  * zakłada że poniższe parametry wejściowe są poprawne:
@@ -19,445 +93,768 @@ pair_t make_pair(uint32_t st, uint32_t nd){
   return to_return;
 }
 
-/* @brief Sprawdza, czy dwie zmienne typu pairt_t są równe.
- * @param[in] a  – pierwsza zmienna typu pair_t,
- * @param[in] b  – druga zmienna typu pair_t
- * Sprawdza, czy @p a.st jest równe @p a.st.
- * Sprawdza, czy @p a.nd jest równe @p a.nd
- * @return Wartość @p true zachodzi równość
- * a @p false w przeciwnym przypadku.
+/* @brief Podaje indeks pola (x, y) w tablicach planszy.
+ * Tablice zapisane są wierszami i otoczone ramką o szerokości jednego pola.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] x       – współrzędna x-owa pola,
+ * @param[in] y       – współrzędna y-owa pola.
+ * @return Indeks pola.
  */
-bool equal(pair_t a, pair_t b){
-  if(a.st != b.st || a.nd != b.nd) return false;
-  return true;
+uint64_t cell(gamma_t *g, uint32_t x, uint32_t y){
+  return ((uint64_t)y + 1) * g->stride + x + 1;
 }
 
-/* @brief Inicjalizuje struktury parent i rank
- * Dla każdego pola, ustawia wartość rank na zero.
- * Dla każdego pola, ustawia wartość parent na parę, której pierwszym elementem
- * jest współrzędna x-owa pola, a drugim elementem jest współrzędna y-owa pola.
- * @param[in] parent  – tablica parent struktury find and union, w której
- *                      przechowywany jest bezpośredni przodeg danego pola,
- * @param[in] rank    – tablica rang elementów find and union, w której
- *                      przechowywana jest odległość od najdalszego dziecka,
- * @param[in] width   – szerokość tablic @p rank oraz @p parent,
- * @param[in] height – wysokość tablic @p rank oraz @p parent
- *                      @p players z funkcji @ref gamma_new.
- */
-void fu_init(pair_t** parent, uint32_t** rank, uint32_t width, uint32_t height){
-  for(uint32_t x = 0; x < width; x++){
-    for(uint32_t y = 0; y < height; y++){
-      parent[x][y].st = x;
-      parent[x][y].nd = y;
-      rank[x][y] = 0;
-    }
-  }
+/* @brief Podaje współrzędną x-ową pola o danym indeksie.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola.
+ * @return Współrzędna x-owa pola.
+ */
+uint32_t cell_x(gamma_t *g, uint64_t i){
+  return (uint32_t)(i % g->stride - 1);
 }
 
-/* @brief Znajduje najdalszego przodka (reprezentanta)
- * Podaje liczbę wolnych pól, na których w danym stanie gry gracz @p player może
- * postawić swój pionek w następnym ruchu.
+/* @brief Podaje współrzędną y-ową pola o danym indeksie.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola.
+ * @return Współrzędna y-owa pola.
+ */
+uint32_t cell_y(gamma_t *g, uint64_t i){
+  return (uint32_t)(i / g->stride - 1);
+}
+
+/* @brief Podaje długość tablic planszy razem z ramką.
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
+ * @return Liczba pól tablic planszy.
+ */
+uint64_t cell_count(gamma_t *g){
+  return g->stride * ((uint64_t)g->height + 2);
+}
+
+/* @brief Zapisuje ojca pola w tablicy ojcostwa.
+ * Reprezentant obszaru ma w tablicy ojcostwa zero (indeks 0 to róg ramki,
+ * który nie jest niczyim ojcem), więc niezainicjowana tablica oznacza,
+ * że każde pole jest swoim własnym reprezentantem.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola,
+ * @param[in] p       – indeks ojca pola.
+ */
+void fu_set_parent(gamma_t *g, uint64_t i, uint64_t p){
+  g->parent[i] = (p == i) ? 0 : p;
+}
+
+/* @brief Znajduje najdalszego przodka (reprezentanta) i liczy długość ścieżki
+ * Każde pole na ścieżce dostaje reprezentanta za ojca.
  * @param[in] parent – tabilca ojcostwa struktury find and union,
- * @param[in] p      – współrzędne pola w tablicy, dla którego chcemy znaleźć
+ * @param[in] i      – indeks pola, dla którego chcemy znaleźć
+ *                     najdalszego przodka,
+ * @param[out] depth – zwiększane o liczbę przejrzanych krawędzi ścieżki.
+ * @return Indeks najdalszego przodka.
+ */
+uint64_t fu_find_path(uint64_t *parent, uint64_t i, uint64_t *depth){
+  if(parent[i] == 0) return i;
+  (*depth)++;
+  parent[i] = fu_find_path(parent, parent[i], depth);
+  return parent[i];
+}
+
+/* @brief Znajduje najdalszego przodka (reprezentanta)
+ * @param[in] g      – wskaźnik na strukturę gamma_t,
+ * @param[in] i      – indeks pola, dla którego chcemy znaleźć
  *                     najdalszego przodka.
- * @return Para, której przerwszym elementem jest pierwsza współrzędna
- * najdalszego przodka, a drugim elementem jest druga współrzędna tego przodka.
+ * @return Indeks najdalszego przodka.
  */
-pair_t* fu_find(pair_t** parent, pair_t* p){
-  if((parent[p->st][p->nd]).st != p->st
-  || (parent[p->st][p->nd]).nd != p->nd){
-    *p = *(fu_find(parent, &(parent[p->st][p->nd])));
-  }
-  return p;
+uint64_t fu_find(gamma_t *g, uint64_t i){
+  uint64_t depth = 0;
+  uint64_t rep = fu_find_path(g->parent, i, &depth);
+  STATS_ADD(g, fu_find_calls, 1);
+  STATS_ADD(g, fu_find_depth, depth);
+  STATS_MAX(g, fu_find_depth_max, depth);
+  return rep;
 }
 
-/* @brief Łączy dwa alementy ze sobą
- * Łączy ze sobą dwa pola struktury find and union.
- * Zmienia tablicę ojcostwa. Jako ojca reprezentanta pola o mniejszej randze
- * ustawia reprezentanta pola o większej randze.
- * Aktualizuje tablicę @p rank.
- * @param[in] parent – tabilca ojcostwa struktury find and union,
- * @param[in] rank   – tablica rang elementów struktury find and union,
- * @param[in] a      – współrzędne pierwszego pola reprezentowane jako para,
- * @param[in] b      – współrzędne drugiego pola reprezentowane jako para.
+/* @brief Znajduje stan gracza.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] player  – numer gracza.
+ * @return Wskaźnik na stan gracza lub NULL, jeśli gracz nie ma stanu.
+ * Wskaźnik jest ważny do utworzenia stanu kolejnego gracza.
  */
-void fu_union(pair_t** parent, uint32_t** rank, pair_t* a, pair_t* b){
-  pair_t par_a = *fu_find(parent, a);
-  pair_t par_b = *fu_find(parent, b);
-  if(rank[a->st][a->nd] < rank[b->st][b->nd]){
-    parent[par_a.st][par_a.nd] = par_b;
-  }
-  else{
-    parent[par_b.st][par_b.nd] = par_a;
-  }
-  if(rank[a->st][a->nd] == rank[b->st][b->nd]){
-    rank[a->st][a->nd]++;
-  }
+gamma_player_t* player_find(gamma_t *g, uint32_t player){
+  uint32_t slot = (player * PLAYER_HASH) & g->active_mask;
+  while(g->active_slots[slot] != 0){
+    gamma_player_t *state = &g->active[g->active_slots[slot] - 1];
+    if(state->player == player) return state;
+    slot = (slot + 1) & g->active_mask;
+  }
+  return NULL;
 }
 
-//zakłada że pola należą do tego samego gracza oraz low jest aktualny
-bool low_is_parent(gamma_t *g, uint32_t x_p, uint32_t y_p,
-                   uint32_t x_s, uint32_t y_s){
-  if(g->low_visit_time[x_p][y_p] > g->low_visit_time[x_s][y_s])
-    return false;
+/* @brief Podaje stan gracza do odczytu.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] player  – numer gracza.
+ * @return Wskaźnik na stan gracza, a jeśli gracz nie ma stanu – na stan
+ * z zerowymi licznikami.
+ */
+const gamma_player_t* player_view(gamma_t *g, uint32_t player){
+  static const gamma_player_t inactive_player;
+  const gamma_player_t *state = player_find(g, player);
+  return state != NULL ? state : &inactive_player;
+}
 
-  if(x_s != 0
-  && g->low_visit_time[x_s][y_s] > g->low_visit_time[x_s - 1][y_s]
-  && g->low_visit_time[x_s - 1][y_s] > g->low_visit_time[x_p][y_p])
-    return false;
+/* @brief Wstawia do tablicy haszującej pozycję stanu gracza.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] index   – pozycja stanu w tablicy @p active.
+ */
+void player_slot_insert(gamma_t *g, uint32_t index){
+  uint32_t slot = (g->active[index].player * PLAYER_HASH) & g->active_mask;
+  while(g->active_slots[slot] != 0) slot = (slot + 1) & g->active_mask;
+  g->active_slots[slot] = index + 1;
+}
 
-  if(x_s != g->width - 1
-  && g->low_visit_time[x_s][y_s] > g->low_visit_time[x_s + 1][y_s]
-  && g->low_visit_time[x_s + 1][y_s] > g->low_visit_time[x_p][y_p])
-    return false;
+/* @brief Zapewnia miejsce na stan jeszcze jednego gracza.
+ * Podwaja tablice stanów i graczy ruchomych, gdy są pełne, oraz tablicę
+ * haszującą, gdy byłaby zapełniona w więcej niż połowie.
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
+ * @return Wartość @p true jeśli alokacja powiodła się,
+ * a @p false w przeciwnym razie.
+ */
+bool player_reserve(gamma_t *g){
+  if(g->active_count == g->active_cap){
+    uint32_t cap = 2 * g->active_cap;
+    gamma_player_t *active = realloc(g->active, cap*sizeof(gamma_player_t));
+    if(active == NULL) return false;
+    g->active = active;
+    uint32_t *mobile = realloc(g->mobile, cap*sizeof(uint32_t));
+    if(mobile == NULL) return false;
+    g->mobile = mobile;
+    g->active_cap = cap;
+  }
+  if(2 * ((uint64_t)g->active_count + 1) > (uint64_t)g->active_mask + 1){
+    uint64_t size = 2 * ((uint64_t)g->active_mask + 1);
+    uint32_t *slots = calloc(1, size*sizeof(uint32_t));
+    if(slots == NULL) return false;
+    free(g->active_slots);
+    g->active_slots = slots;
+    g->active_mask = (uint32_t)(size - 1);
+    for(uint32_t i = 0; i < g->active_count; i++) player_slot_insert(g, i);
+  }
+  return true;
+}
 
-  if(y_s != 0
-  && g->low_visit_time[x_s][y_s] > g->low_visit_time[x_s][y_s - 1]
-  && g->low_visit_time[x_s][y_s - 1] > g->low_visit_time[x_p][y_p])
-    return false;
+/* @brief Podaje stan gracza, tworząc go, jeśli gracz go jeszcze nie ma.
+ * Utworzenie stanu unieważnia wcześniej pobrane wskaźniki na stany.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] player  – numer gracza.
+ * @return Wskaźnik na stan gracza lub NULL, jeśli alokacja nie powiodła się.
+ */
+gamma_player_t* player_get(gamma_t *g, uint32_t player){
+  gamma_player_t *state = player_find(g, player);
+  if(state != NULL) return state;
+  if(!player_reserve(g)) return NULL;
+  state = &g->active[g->active_count];
+  //rejestr obszarów pozostały po poprzedniej grze (@ref gamma_reset)
+  gamma_area_t *area_list = NULL;
+  uint64_t area_cap = 0;
+  if(g->active_count < g->active_used){
+    area_list = state->area_list;
+    area_cap = state->area_cap;
+  }
+  memset(state, 0, sizeof(gamma_player_t));
+  state->player = player;
+  state->area_list = area_list;
+  state->area_cap = area_cap;
+  player_slot_insert(g, g->active_count++);
+  if(g->active_used < g->active_count) g->active_used = g->active_count;
+  //gracz bez stanu był ruchomy tak jak każdy inny gracz bez stanu,
+  //więc podsumowanie możliwości ruchu trzeba wyznaczyć od nowa
+  g->mobility_valid = false;
+  return state;
+}
 
-  if(y_s != g->height - 1
-  && g->low_visit_time[x_s][y_s] > g->low_visit_time[x_s][y_s + 1]
-  && g->low_visit_time[x_s][y_s + 1] > g->low_visit_time[x_p][y_p])
-    return false;
+/* @brief Sprawdza, czy pole jest zapisane w rejestrze obszarów gracza.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza,
+ * @param[in] root    – indeks pola.
+ * @return Wartość @p true, jeśli pole jest reprezentantem obszaru z rejestru,
+ * a @p false w przeciwnym razie.
+ */
+bool area_registered(gamma_t *g, gamma_player_t *state, uint64_t root){
+  uint32_t i = g->area_index[root];
+  return i < state->area_count
+      && cell(g, state->area_list[i].x, state->area_list[i].y) == root;
+}
 
+/* @brief Zapewnia miejsce na @p extra nowych obszarów w rejestrze gracza.
+ * @param[in] state   – stan gracza,
+ * @param[in] extra   – liczba obszarów, które mogą zostać dodane.
+ * @return Wartość @p true jeśli alokacja powiodła się,
+ * a @p false w przeciwnym razie.
+ */
+bool area_reserve(gamma_player_t *state, uint64_t extra){
+  uint64_t need = state->area_count + extra;
+  if(need <= state->area_cap) return true;
+  gamma_area_t *list = realloc(state->area_list,
+                               2 * need * sizeof(gamma_area_t));
+  if(list == NULL) return false;
+  state->area_list = list;
+  state->area_cap = 2 * need;
   return true;
 }
 
-bool low_up_to_date_area(gamma_t *g, uint32_t x, uint32_t y){
-  pair_t xy = make_pair(x, y);
-  pair_t rep = *fu_find(g->parent, &xy);
-  return (g->low_visit_time[rep.st][rep.nd] != 0);
+/* @brief Dodaje obszar do rejestru obszarów gracza.
+ * Rejestr musi mieć miejsce na nowy obszar (@ref area_reserve).
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza,
+ * @param[in] root    – indeks reprezentanta obszaru,
+ * @param[in] size    – liczba pól obszaru.
+ */
+void area_add(gamma_t *g, gamma_player_t *state, uint64_t root, uint64_t size){
+  uint64_t i = state->area_count++;
+  state->area_list[i].x = cell_x(g, root);
+  state->area_list[i].y = cell_y(g, root);
+  state->area_list[i].size = size;
+  g->area_index[root] = (uint32_t)i;
 }
 
-void low_set_not_up_to_date(gamma_t *g, uint32_t x, uint32_t y){
-  pair_t xy = make_pair(x, y);
-  pair_t *rep = fu_find(g->parent, &xy);
-  g->low_visit_time[rep->st][rep->nd] = 0;
+/* @brief Usuwa obszar z rejestru obszarów gracza.
+ * Na jego miejsce przenosi ostatni obszar rejestru.
+ * Nic nie robi, jeśli pole nie jest zapisane w rejestrze.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza,
+ * @param[in] root    – indeks reprezentanta obszaru.
+ */
+void area_remove(gamma_t *g, gamma_player_t *state, uint64_t root){
+  if(!area_registered(g, state, root)) return;
+  uint32_t i = g->area_index[root];
+  gamma_area_t *list = state->area_list;
+  list[i] = list[--state->area_count];
+  g->area_index[cell(g, list[i].x, list[i].y)] = i;
 }
 
-void low_clear(gamma_t *g, uint32_t x, uint32_t y){
-  g->low_visit_time[x][y] = 0;
+/* @brief Podaje liczbę pól obszaru.
+ * Pole spoza rejestru to nowy, jednopolowy obszar.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza,
+ * @param[in] root    – indeks reprezentanta obszaru.
+ * @return Liczba pól obszaru.
+ */
+uint64_t area_size(gamma_t *g, gamma_player_t *state, uint64_t root){
+  if(!area_registered(g, state, root)) return 1;
+  return state->area_list[g->area_index[root]].size;
+}
 
-  if(x != 0
-  && g->board[x - 1][y] == g->board[x][y]
-  && g->low_visit_time[x - 1][y] != 0){
-    low_clear(g, x - 1, y);
-  }
-  if(x != g->width - 1
-  && g->board[x + 1][y] == g->board[x][y]
-  && g->low_visit_time[x + 1][y] != 0){
-    low_clear(g, x + 1, y);
-  }
-  if(y != 0
-  && g->board[x][y - 1] == g->board[x][y]
-  && g->low_visit_time[x][y - 1] != 0){
-    low_clear(g, x, y - 1);
+/* @brief Aktualizuje rejestr obszarów gracza po połączeniu dwóch obszarów.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza,
+ * @param[in] kept    – indeks reprezentanta połączonego obszaru,
+ * @param[in] gone    – indeks dotychczasowego reprezentanta dołączonego
+ *                      obszaru.
+ */
+void area_merge(gamma_t *g, gamma_player_t *state, uint64_t kept,
+                uint64_t gone){
+  uint64_t size = area_size(g, state, kept) + area_size(g, state, gone);
+  area_remove(g, state, gone);
+  if(area_registered(g, state, kept))
+    state->area_list[g->area_index[kept]].size = size;
+  else
+    area_add(g, state, kept, size);
+}
+
+/* @brief Łączy dwa alementy ze sobą
+ * Łączy ze sobą dwa pola struktury find and union.
+ * Zmienia tablicę ojcostwa. Jako ojca reprezentanta pola o mniejszej randze
+ * ustawia reprezentanta pola o większej randze.
+ * Aktualizuje tablicę @p rank oraz rejestr obszarów gracza.
+ * @param[in] g      – wskaźnik na strukturę gamma_t,
+ * @param[in] state  – stan gracza, do którego należą łączone obszary,
+ * @param[in] a      – indeks pierwszego pola,
+ * @param[in] b      – indeks drugiego pola.
+ */
+void fu_union(gamma_t *g, gamma_player_t *state, uint64_t a, uint64_t b){
+  uint64_t par_a = fu_find(g, a);
+  uint64_t par_b = fu_find(g, b);
+  if(par_a == par_b) return;
+  if(g->rank[par_a] < g->rank[par_b]){
+    g->parent[par_a] = par_b;
+    area_merge(g, state, par_b, par_a);
   }
-  if(y != g->height - 1
-  && g->board[x][y + 1] == g->board[x][y]
-  && g->low_visit_time[x][y + 1] != 0){
-    low_clear(g, x, y + 1);
+  else{
+    g->parent[par_b] = par_a;
+    area_merge(g, state, par_a, par_b);
+    if(g->rank[par_a] == g->rank[par_b]) g->rank[par_a]++;
   }
 }
 
-void low_compute(gamma_t *g, uint32_t x, uint32_t y, uint64_t *visit_time);
+/* @brief Podaje numer krawędzi między polem @p i a jego sąsiadem @p k.
+ * Krawędź poziomą zapisujemy przy jej lewym, a pionową przy górnym końcu,
+ * więc oba końce krawędzi dają ten sam numer.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola,
+ * @param[in] k       – numer sąsiada (indeks w tablicy neighbour).
+ * @return Numer krawędzi: podwojony indeks pola, przy którym jest zapisana,
+ * plus jeden dla krawędzi pionowej.
+ */
+uint64_t edge_id(gamma_t *g, uint64_t i, uint32_t k){
+  uint64_t lower = (k & 1) ? i : i + g->neighbour[k];
+  return 2 * lower + (k >> 1);
+}
 
-void low_compute_son(gamma_t *g, uint32_t x_p, uint32_t y_p,
-                     uint64_t *visit_time, uint32_t x_s, uint32_t y_s){
-  if(g->low_visit_time[x_s][y_s] == 0){ //(x_s, y_s) zostaje synem (x_p, y_p)
-    low_compute(g, x_s, y_s, visit_time);
-    if(g->low[x_p][y_p] > g->low[x_s][y_s]){
-      g->low[x_p][y_p] = g->low[x_s][y_s];
-    }
-  }else{ //(x_s, y_s) ma już ojca
-    if(low_is_parent(g, x_s, y_s, x_p, y_p)) //(x_s, y_s) jest ojcem (x_p, y_p)
-      return;
+/* @brief Podaje wpis krawędzi @p e w strukturze find and union bloków.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] e       – numer krawędzi.
+ * @return Wskaźnik na wpis krawędzi.
+ */
+uint64_t* block_node(gamma_t *g, uint64_t e){
+  return (e & 1) ? &g->block_v[e >> 1] : &g->block_h[e >> 1];
+}
 
-    if(g->low[x_p][y_p] > g->low_visit_time[x_s][y_s])
-      g->low[x_p][y_p] = g->low_visit_time[x_s][y_s];
-  }
+/* @brief Znajduje reprezentanta bloku, do którego należy krawędź @p e.
+ * Każda krawędź na ścieżce dostaje za ojca swojego dziadka.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] e       – numer krawędzi drzewa rozpinającego.
+ * @return Numer krawędzi będącej reprezentantem bloku.
+ */
+uint64_t block_find(gamma_t *g, uint64_t e){
+  uint64_t *node = block_node(g, e);
+  while((*node & BLOCK_HEAD) == 0){
+    uint64_t up = *node;
+    uint64_t *up_node = block_node(g, up);
+    if((*up_node & BLOCK_HEAD) == 0) *node = *up_node;
+    e = up;
+    node = up_node;
+  }
+  return e;
 }
 
-void low_compute(gamma_t *g, uint32_t x, uint32_t y, uint64_t *visit_time){
-  (*visit_time)++;
-  g->low_visit_time[x][y] = *visit_time;
-  g->low[x][y] = *visit_time;
+/* @brief Podaje najwyższe pole bloku w drzewie rozpinającym.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] b       – reprezentant bloku.
+ * @return Indeks pola, z którego blok zwisa.
+ */
+uint64_t block_head(gamma_t *g, uint64_t b){
+  return *block_node(g, b) & ~BLOCK_HEAD;
+}
 
-  if(x != 0 && g->board[x - 1][y] == g->board[x][y]){
-    low_compute_son(g, x, y, visit_time, x - 1, y);
-  }
+/* @brief Czyni krawędź @p e reprezentantem bloku zwisającego z pola @p head.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] e       – numer krawędzi,
+ * @param[in] head    – indeks najwyższego pola bloku.
+ */
+void block_set_head(gamma_t *g, uint64_t e, uint64_t head){
+  *block_node(g, e) = BLOCK_HEAD | head;
+}
 
-  if(x != g->width - 1 && g->board[x + 1][y] == g->board[x][y]){
-    low_compute_son(g, x, y, visit_time, x + 1, y);
-  }
+/* @brief Podaje krawędź drzewa rozpinającego między polem a jego ojcem.
+ * Pole nie może być korzeniem.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola.
+ * @return Numer krawędzi.
+ */
+uint64_t tree_edge(gamma_t *g, uint64_t i){
+  return edge_id(g, i, g->tree_up[i] - 1);
+}
 
-  if(y != 0 && g->board[x][y - 1] == g->board[x][y]){
-    low_compute_son(g, x, y, visit_time, x, y - 1);
-  }
+/* @brief Podaje najwyższe pole bloku krawędzi między polem a jego ojcem.
+ * Pole nie może być korzeniem.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola.
+ * @return Indeks pola.
+ */
+uint64_t block_up(gamma_t *g, uint64_t i){
+  STATS_ADD(g, block_steps, 1);
+  return block_head(g, block_find(g, tree_edge(g, i)));
+}
 
-  if(y != g->height - 1 && g->board[x][y + 1] == g->board[x][y]){
-    low_compute_son(g, x, y, visit_time, x, y + 1);
-  }
+/* @brief Podwiesza pole @p i, które jest korzeniem, pod jego sąsiada @p k.
+ * Krawędź między nimi tworzy nowy blok.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola,
+ * @param[in] k       – numer sąsiada, który zostaje ojcem pola.
+ */
+void block_attach(gamma_t *g, uint64_t i, uint32_t k){
+  g->tree_up[i] = (uint8_t)(k + 1);
+  block_set_head(g, edge_id(g, i, k), i + g->neighbour[k]);
 }
 
-void low_update(gamma_t *g, uint32_t x, uint32_t y){
-  if(low_up_to_date_area(g, x, y)){
-    return;
-  }
-  low_clear(g, x, y);
-  uint64_t visit_time = 0;
-  low_compute(g, x, y, &visit_time);
+/* @brief Czyni pole @p i korzeniem jego drzewa rozpinającego.
+ * Odwraca krawędzie na ścieżce od @p i do dotychczasowego korzenia.
+ * Najwyższym polem każdego bloku na tej ścieżce zostaje jego pole
+ * najbliższe @p i; bloki spoza ścieżki się nie zmieniają.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola.
+ */
+void block_evert(gamma_t *g, uint64_t i){
+  uint8_t up = 0;
+  uint64_t last = 0;
+  while(g->tree_up[i] != 0){
+    STATS_ADD(g, block_evert_cells, 1);
+    uint32_t k = g->tree_up[i] - 1;
+    //bloki ścieżki są jej spójnymi fragmentami
+    uint64_t b = block_find(g, edge_id(g, i, k));
+    if(b != last) block_set_head(g, b, i);
+    last = b;
+    g->tree_up[i] = up;
+    up = (uint8_t)((k ^ 1) + 1);
+    i += g->neighbour[k];
+  }
+  g->tree_up[i] = up;
 }
 
-void low_update_all(gamma_t *g){
-  for(uint32_t x = 0; x < g->width; x++){
-    for(uint32_t y = 0; y < g->height; y++){
-      if(g->board[x][y] != 0)
-        low_update(g, x, y);
+/* @brief Łączy bloki na ścieżce od pola @p i w górę do pola @p top.
+ * Najwyższym polem połączonego bloku od razu zostaje @p top, więc przejście
+ * drugiej strony ścieżki przez już połączony blok prowadzi wprost do @p top.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola,
+ * @param[in] top     – indeks pola, które jest najwyższym polem jednego
+ *                      z bloków nad @p i,
+ * @param[in] root    – reprezentant, do którego dołączane są bloki, lub 0.
+ * @return Reprezentant połączonego bloku lub 0, jeśli @p i to @p top.
+ */
+uint64_t block_merge_up(gamma_t *g, uint64_t i, uint64_t top, uint64_t root){
+  while(i != top){
+    STATS_ADD(g, block_steps, 1);
+    uint64_t b = block_find(g, tree_edge(g, i));
+    i = block_head(g, b);
+    if(root == 0){
+      root = b;
+      block_set_head(g, root, top);
+    }
+    else if(b != root){
+      *block_node(g, b) = root;
     }
   }
+  return root;
 }
 
-bool low_bridge(gamma_t *g, uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2){
-  if(g->board[x1][y1] != g->board[x2][y2]
-  || g->board[x1][y1] == 0
-  || g->board[x2][y2] == 0)
-    return false;
+/* @brief Uwzględnia krawędź między polami jednego drzewa rozpinającego.
+ * Krawędź zamyka cykl, więc wszystkie bloki na ścieżce drzewa między
+ * polami łączą się w jeden. Najwyższe pola bloków na ścieżce są odwiedzane
+ * na przemian od obu końców, aż jedna strona dojdzie do pola odwiedzonego
+ * przez drugą – to najwyższe pole połączonego bloku.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] a       – indeks pierwszego pola,
+ * @param[in] b       – indeks drugiego pola.
+ */
+void block_merge_path(gamma_t *g, uint64_t a, uint64_t b){
+  g->block_stamp += 2;
+  uint64_t mark_a = g->block_stamp, mark_b = mark_a + 1;
+  g->block_mark[a] = mark_a;
+  g->block_mark[b] = mark_b;
+  uint64_t top = 0, i = a, j = b;
+  while(top == 0){
+    if(g->tree_up[i] != 0){
+      i = block_up(g, i);
+      if(g->block_mark[i] == mark_b) top = i;
+      g->block_mark[i] = mark_a;
+    }
+    if(top == 0 && g->tree_up[j] != 0){
+      j = block_up(g, j);
+      if(g->block_mark[j] == mark_a) top = j;
+      g->block_mark[j] = mark_b;
+    }
+  }
+  uint64_t root = block_merge_up(g, a, top, 0);
+  block_merge_up(g, b, top, root);
+}
 
-  if(low_is_parent(g, x1, y1, x2, y2)
-  && g->low[x2][y2] == g->low_visit_time[x2][y2])
-    return true;
+/* @brief Dołącza do lasu rozpinającego krawędź od nowego pola @p i
+ * do jego sąsiada @p k z innego obszaru.
+ * Podwieszane jest drzewo mniejszego z łączonych obszarów, więc każde pole
+ * leży na odwracanej ścieżce co najwyżej logarytmicznie wiele razy.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza, do którego należą łączone obszary,
+ * @param[in] i       – indeks pola,
+ * @param[in] k       – numer sąsiada.
+ */
+void block_link(gamma_t *g, gamma_player_t *state, uint64_t i, uint32_t k){
+  uint64_t n = i + g->neighbour[k];
+  if(area_size(g, state, fu_find(g, n)) < area_size(g, state, fu_find(g, i))){
+    block_evert(g, n);
+    block_attach(g, n, k ^ 1);
+  }
+  else{
+    block_evert(g, i);
+    block_attach(g, i, k);
+  }
+}
 
-  if(low_is_parent(g, x2, y2, x1, y1)
-  && g->low[x1][y1] == g->low_visit_time[x1][y1])
-    return true;
+/* @brief Dodaje pole @p i do drzewa rozpinającego odtwarzanego obszaru.
+ * Wywoływana przez gamma_fu_recreate, gdy pola obszaru bez nowego
+ * reprezentanta mają w tablicy ojcostwa @ref FU_NONE.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola,
+ * @param[in] up      – numer sąsiada, który jest ojcem pola, plus jeden,
+ *                      lub 0, jeśli pole jest korzeniem.
+ */
+void block_insert(gamma_t *g, uint64_t i, uint8_t up){
+  g->tree_up[i] = 0;
+  if(up != 0) block_attach(g, i, up - 1);
+  for(uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++){
+    uint64_t n = i + g->neighbour[k];
+    if(k + 1 != up && g->board[n] == g->board[i] && g->parent[n] != FU_NONE)
+      block_merge_path(g, i, n);
+  }
+}
 
-  return false;
+/* @brief Liczy bloki, do których należy pole @p i.
+ * Tyle obszarów powstanie z obszaru pola po jego usunięciu. Wystarczą
+ * krawędzie drzewa rozpinającego – każda inna krawędź pola należy do
+ * bloku pierwszej krawędzi drzewa na ścieżce, którą zamyka.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola.
+ * @return Liczba bloków.
+ */
+uint64_t block_count(gamma_t *g, uint64_t i){
+  uint64_t blocks[GAMMA_NEIGHBOURS];
+  uint32_t count = 0;
+  if(g->tree_up[i] != 0) blocks[count++] = block_find(g, tree_edge(g, i));
+  for(uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++){
+    uint64_t n = i + g->neighbour[k];
+    if(g->board[n] != g->board[i] || g->tree_up[n] != (k ^ 1) + 1) continue;
+    uint64_t b = block_find(g, edge_id(g, i, k));
+    bool counted = false;
+    for(uint32_t j = 0; j < count; j++)
+      if(blocks[j] == b) counted = true;
+    if(!counted) blocks[count++] = b;
+  }
+  return count;
 }
 
-bool low_articulation_point(gamma_t *g, uint32_t x, uint32_t y){
-  if(g->low_visit_time[x][y] == 1){
-    uint32_t sons = 0;
-    if(x != 0 && g->board[x - 1][y] == g->board[x][y]) sons++;
-    if(x != g->width - 1 && g->board[x + 1][y] == g->board[x][y]) sons++;
-    if(y != 0 && g->board[x][y - 1] == g->board[x][y]) sons++;
-    if(x != g->height - 1 && g->board[x][y + 1] == g->board[x][y]) sons++;
-    return (sons > 1);
+/* @brief Usuwa drzewa, z których korzysta @ref gamma_rect_count.
+ * @param[in,out] g   – wskaźnik na strukturę gamma_t.
+ */
+void rect_trees_clear(gamma_t *g){
+  for(uint32_t t = 0; t < g->rect_tree_count; t++){
+    free(g->rect_trees[t].counts);
+    g->rect_trees[t].counts = NULL;
   }
-  if(x != 0 && g->board[x - 1][y] == g->board[x][y]
-  && low_is_parent(g, x, y, x - 1, y)
-  && g->low[x - 1][y] >= g->low_visit_time[x][y])
-    return true;
-
-  if(x != g->width - 1 && g->board[x + 1][y] == g->board[x][y]
-  && low_is_parent(g, x, y, x + 1, y)
-  && g->low[x + 1][y] >= g->low_visit_time[x][y])
-    return true;
+  g->rect_tree_count = 0;
+  g->rect_scanned = 0;
+}
 
-  if(y != 0 && g->board[x][y - 1] == g->board[x][y]
-  && low_is_parent(g, x, y, x, y - 1)
-  && g->low[x][y - 1] >= g->low_visit_time[x][y])
-    return true;
+/* @brief Podaje liczbę bloków drzew @ref gamma_rect_count w wierszu.
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
+ * @return Liczba bloków.
+ */
+uint64_t rect_blocks_x(gamma_t *g){
+  return ((uint64_t)g->width + GAMMA_RECT_BLOCK - 1) / GAMMA_RECT_BLOCK;
+}
 
-  if(y != g->height - 1 && g->board[x][y + 1] == g->board[x][y]
-  && low_is_parent(g, x, y, x, y + 1)
-  && g->low[x][y + 1] >= g->low_visit_time[x][y])
-    return true;
+/* @brief Podaje liczbę bloków drzew @ref gamma_rect_count w kolumnie.
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
+ * @return Liczba bloków.
+ */
+uint64_t rect_blocks_y(gamma_t *g){
+  return ((uint64_t)g->height + GAMMA_RECT_BLOCK - 1) / GAMMA_RECT_BLOCK;
+}
 
-  return false;
+/* @brief Aktualizuje drzewa po zmianie pola.
+ * Zmienia o @p delta liczniki w drzewach gracza @p player i w drzewie
+ * wszystkich zajętych pól.
+ * @param[in,out] g   – wskaźnik na strukturę gamma_t,
+ * @param[in] x       – współrzędna x-owa pola,
+ * @param[in] y       – współrzędna y-owa pola,
+ * @param[in] player  – gracz, którego pionek stanął na polu lub zszedł z niego,
+ * @param[in] delta   – 1 lub (uint64_t)-1; liczniki liczone są modulo 2^64,
+ *                      a ich prawdziwe wartości są nieujemne.
+ */
+void rect_trees_add(gamma_t *g, uint32_t x, uint32_t y, uint32_t player,
+                    uint64_t delta){
+  uint64_t bw = rect_blocks_x(g), bh = rect_blocks_y(g);
+  for(uint32_t t = 0; t < g->rect_tree_count; t++){
+    gamma_rect_tree_t *tree = &g->rect_trees[t];
+    if(tree->player != player && tree->player != 0) continue;
+    for(uint64_t j = y / GAMMA_RECT_BLOCK + 1; j <= bh; j += j & -j)
+      for(uint64_t k = x / GAMMA_RECT_BLOCK + 1; k <= bw; k += k & -k)
+        tree->counts[(j - 1) * bw + k - 1] += delta;
+  }
 }
 
 void gamma_delete(gamma_t *g){
   if(g == NULL) return;
-  if(g->fields_next_to != NULL) free(g->fields_next_to);
-  if(g->busy_fields != NULL) free(g->busy_fields);
-  if(g->used_areas != NULL) free(g->used_areas);
-  if(g->board != NULL){
-    for(uint32_t i = 0; i < g->width; i++)
-      if((g->board)[i] != NULL) free((g->board)[i]);
-    free(g->board);
-  }
-  if(g->is_golden_used != NULL) free(g->is_golden_used);
-  if(g->parent != NULL){
-    for(uint32_t i = 0; i < g->width; i++)
-      if((g->parent)[i] != NULL) free((g->parent)[i]);
-    free(g->parent);
-  }
-  if(g->rank != NULL){
-    for(uint32_t i = 0; i < g->width; i++)
-      if((g->rank)[i] != NULL) free((g->rank)[i]);
-    free(g->rank);
-  }
-  if(g->low != NULL){
-    for(uint32_t i = 0; i < g->width; i++)
-      if((g->low)[i] != NULL) free((g->low)[i]);
-    free(g->low);
-  }
-  if(g->low_visit_time != NULL){
-    for(uint32_t i = 0; i < g->width; i++)
-      if((g->low_visit_time)[i] != NULL) free((g->low_visit_time)[i]);
-    free(g->low_visit_time);
-  }
+  rect_trees_clear(g);
+  if(g->active != NULL){
+    for(uint32_t i = 0; i < g->active_used; i++)
+      if(g->active[i].area_list != NULL) free(g->active[i].area_list);
+    free(g->active);
+  }
+  if(g->active_slots != NULL) free(g->active_slots);
+  if(g->mobile != NULL) free(g->mobile);
+  if(g->board != NULL) free(g->board);
+  if(g->parent != NULL) free(g->parent);
+  if(g->rank != NULL) free(g->rank);
+  if(g->tree_up != NULL) free(g->tree_up);
+  if(g->block_h != NULL) free(g->block_h);
+  if(g->block_v != NULL) free(g->block_v);
+  if(g->block_mark != NULL) free(g->block_mark);
+  if(g->changes != NULL) free(g->changes);
+  while(g->standings != NULL){
+    gamma_bucket_t *next = g->standings->next;
+    free(g->standings);
+    g->standings = next;
+  }
+  while(g->free_buckets != NULL){
+    gamma_bucket_t *next = g->free_buckets->next;
+    free(g->free_buckets);
+    g->free_buckets = next;
+  }
+  if(g->area_index != NULL) free(g->area_index);
   free(g);
 }
 
 
-/* @brief Alokuje tablicę jednowymiarową.
- * Tablica alokowana jest jako is_golden_used struktury gamma.
+/* @brief Alokuje tablice stanów graczy.
+ * Stany tworzone są dopiero przy pierwszym ruchu gracza, więc rozmiar
+ * tablic nie zależy od liczby graczy.
+ * Ustawia wartości areas oraz busy_fields_all.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] players – liczba graczy.
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz.
  * @return Wartość @p true jeśli alokacja powiodła się,
  * a @p false w przeciwnym razie.
  */
-bool gamma_alloc_golden(gamma_t *g, uint32_t players){
-  g->is_golden_used = calloc(1, players*sizeof(bool));
-  if(g->is_golden_used == NULL){
+bool gamma_alloc_players(gamma_t *g, uint32_t areas){
+  g->areas = areas;
+  g->busy_fields_all = 0;
+  g->active_cap = PLAYERS_INITIAL;
+  g->active_mask = 2 * PLAYERS_INITIAL - 1;
+  g->active = malloc(g->active_cap*sizeof(gamma_player_t));
+  g->mobile = malloc(g->active_cap*sizeof(uint32_t));
+  g->active_slots = calloc(1, (g->active_mask + 1)*sizeof(uint32_t));
+  if(g->active == NULL
+  || g->mobile == NULL
+  || g->active_slots == NULL){
     gamma_delete(g);
     return false;
   }
   return true;
 }
 
-/* @brief Alokuje tablicę jednowymiarową.
- * Tablica alokowana jest jako @p used_areas struktury gamma.
- * Ustawia wartość areas na odpowiednią wartość.
+
+/* @brief Alokuje planszę.
+ * Plansza alokowana jest jako @p board struktury gamma razem z ramką.
+ * Tablica jest wyzerowana, więc nie jest przeglądana – pola ramki dostają
+ * wartość @ref GAMMA_BORDER dopiero przy ruchu obok nich
+ * (@ref border_touch). Ustawia szerokość wiersza @p stride
+ * oraz przesunięcia indeksów sąsiednich pól @p neighbour.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] players – liczba graczy
- * @param[in] areas   – maksymalna liczba obszarów,
- *                      jakie może zająć jeden gracz.
+ * @param[in] width   – szerokość planszy,
+ * @param[in] height  – wysokość planszy.
  * @return Wartość @p true jeśli alokacja powiodła się,
  * a @p false w przeciwnym razie.
  */
-bool gamma_alloc_areas(gamma_t *g, uint32_t players, uint32_t areas){
-  g->areas = areas;
-  g->used_areas = calloc(1, players*sizeof(uint32_t));
-  if(g->used_areas == NULL){
+bool gamma_alloc_board(gamma_t *g, uint32_t width){
+  g->stride = (uint64_t)width + 2;
+  g->neighbour[0] = -1;
+  g->neighbour[1] = 1;
+  g->neighbour[2] = -g->stride;
+  g->neighbour[3] = g->stride;
+  g->ring[0] = -g->stride;
+  g->ring[1] = -g->stride + 1;
+  g->ring[2] = 1;
+  g->ring[3] = g->stride + 1;
+  g->ring[4] = g->stride;
+  g->ring[5] = g->stride - 1;
+  g->ring[6] = -1;
+  g->ring[7] = -g->stride - 1;
+  g->board = calloc(cell_count(g), sizeof(uint32_t));
+  if(g->board == NULL){
     gamma_delete(g);
     return false;
   }
   return true;
 }
 
-
-/* @brief Alokuje dwie @p jednowymiarowe.
- * Tablice alokowane są jako odpowiednio @p fields_next_to
- * oraz @p busy_fields struktury gamma.
- * Ustawia wartości busy_fields_all na zero.
- * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] players – liczba graczy
+/* @brief Alokuje tablicę ojcostwa.
+ * Tablica alokowana jest jako @p parent struktury gamma. Jest wyzerowana,
+ * więc każde pole jest na początku swoim własnym reprezentantem
+ * (@ref fu_set_parent).
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
  * @return Wartość @p true jeśli alokacja powiodła się,
  * a @p false w przeciwnym razie.
  */
-bool gamma_alloc_fields(gamma_t *g, uint32_t players){
-  g->fields_next_to = calloc(1, players*sizeof(uint64_t));
-  if(g->fields_next_to == NULL){
-    gamma_delete(g);
-    return false;
-  }
-
-  g->busy_fields = calloc(1, players*sizeof(uint64_t));
-  if(g->busy_fields == NULL){
+bool gamma_alloc_parent(gamma_t *g){
+  g->parent = calloc(cell_count(g), sizeof(uint64_t));
+  if(g->parent == NULL){
     gamma_delete(g);
     return false;
   }
-  g->busy_fields_all = 0;
   return true;
 }
 
-
-/* @brief Alokuje tablicę dwuwymiarową.
- * Tablica alokowana jest jako @p board struktury gamma
- * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] width   – szerokość tablicy,
- * @param[in] height  – wysokość tablicy.
+/* @brief Alokuje tablicę rang.
+ * Tablica alokowana jest jako @p rank struktury gamma
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
  * @return Wartość @p true jeśli alokacja powiodła się,
  * a @p false w przeciwnym razie.
  */
-bool gamma_alloc_board(gamma_t *g, uint32_t width, uint32_t height){
-  g->board = calloc(1, width*sizeof(uint32_t*));
-  if(g->board == NULL){
+bool gamma_alloc_rank(gamma_t *g){
+  g->rank = calloc(cell_count(g), sizeof(uint32_t));
+  if(g->rank == NULL){
     gamma_delete(g);
     return false;
   }
-  for(uint32_t i = 0; i < width; i++){
-    g->board[i] = calloc(1, height*sizeof(uint32_t));
-    if(g->board[i] == NULL){
-      gamma_delete(g);
-      return false;
-    }
-  }
   return true;
 }
 
-/* @brief Alokuje tablicę dwuwymiarową.
- * Tablica alokowana jest jako @p parent struktury gamma
- * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] width   – szerokość tablicy,
- * @param[in] height  – wysokość tablicy.
+/* @brief Alokuje tablice lasu rozpinającego i bloków obszarów.
+ * Tablice są wyzerowane, więc każde pole jest na początku korzeniem,
+ * a żadna krawędź nie należy do bloku. Krawędzie poziome i pionowe mają
+ * osobne tablice, żeby żadna alokacja nie była większa od tablicy ojcostwa.
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
  * @return Wartość @p true jeśli alokacja powiodła się,
  * a @p false w przeciwnym razie.
  */
-bool gamma_alloc_parent(gamma_t *g, uint32_t width, uint32_t height){
-  g->parent = calloc(1, width*sizeof(pair_t*));
-  if(g->parent == NULL){
+bool gamma_alloc_blocks(gamma_t *g){
+  g->tree_up = calloc(cell_count(g), sizeof(uint8_t));
+  g->block_h = calloc(cell_count(g), sizeof(uint64_t));
+  g->block_v = calloc(cell_count(g), sizeof(uint64_t));
+  g->block_mark = calloc(cell_count(g), sizeof(uint64_t));
+  if(g->tree_up == NULL
+  || g->block_h == NULL
+  || g->block_v == NULL
+  || g->block_mark == NULL){
     gamma_delete(g);
     return false;
   }
-  for(uint32_t i = 0; i < width; i++){
-    g->parent[i] = calloc(1, height*sizeof(pair_t));
-    if(g->parent[i] == NULL){
-      gamma_delete(g);
-      return false;
-    }
-    for(uint32_t j = 0; j < height; j++)
-    g->parent[i][j] = make_pair(i, j);
-  }
   return true;
 }
 
-/* @brief Alokuje dwuwymiarową tablicę.
- * Tablica alokowana jest jako @p rank struktury gamma
+/* @brief Alokuje dziennik zmian planszy.
+ * Dziennik jest buforem cyklicznym o rozmiarze równym liczbie pól planszy,
+ * ale nie większym niż @ref GAMMA_CHANGE_LOG_MAX.
+ * Ustawia wersję gry na zero.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] width   – szerokość tablicy,
- * @param[in] height  – wysokość tablicy.
+ * @param[in] width   – szerokość planszy,
+ * @param[in] height  – wysokość planszy.
  * @return Wartość @p true jeśli alokacja powiodła się,
  * a @p false w przeciwnym razie.
  */
-bool gamma_alloc_rank(gamma_t *g, uint32_t width, uint32_t height){
-  g->rank = calloc(1, width*sizeof(uint32_t*));
-  if(g->rank == NULL){
+bool gamma_alloc_changes(gamma_t *g, uint32_t width, uint32_t height){
+  uint64_t cells = (uint64_t)width * height;
+  g->version = 0;
+  g->changes_size = cells < GAMMA_CHANGE_LOG_MAX ? cells : GAMMA_CHANGE_LOG_MAX;
+  g->changes = calloc(1, g->changes_size * sizeof(gamma_change_t));
+  if(g->changes == NULL){
     gamma_delete(g);
     return false;
   }
-  for(uint32_t i = 0; i  < width; i++){
-    g->rank[i] = calloc(1, height*sizeof(uint32_t));
-    if(g->rank[i] == NULL){
-      gamma_delete(g);
-      return false;
-    }
-  }
   return true;
 }
 
-bool gamma_alloc_low(gamma_t *g, uint32_t width, uint32_t height){
-  g->low = calloc(1, width*sizeof(uint64_t*));
-  g->low_visit_time = calloc(1, width*sizeof(uint64_t*));
-  if(g->low == NULL
-  || g->low_visit_time == NULL){
+/* @brief Alokuje rejestr obszarów graczy.
+ * Rejestry graczy są częścią ich stanów i są początkowo puste, a ich tablice
+ * alokowane są przy dodawaniu obszarów. Tu alokowana jest tylko tablica
+ * pozycji obszarów w rejestrach.
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
+ * @return Wartość @p true jeśli alokacja powiodła się,
+ * a @p false w przeciwnym razie.
+ */
+bool gamma_alloc_area_registry(gamma_t *g){
+  g->area_index = calloc(cell_count(g), sizeof(uint32_t));
+  if(g->area_index == NULL){
     gamma_delete(g);
     return false;
   }
-  for(uint32_t i = 0; i  < width; i++){
-    g->low[i] = calloc(1, height*sizeof(uint64_t));
-    g->low_visit_time[i] = calloc(1, height*sizeof(uint64_t));
-    if(g->low[i] == NULL
-    || g->low_visit_time[i] == NULL
-  ){
-      gamma_delete(g);
-      return false;
-    }
-  }
   return true;
 }
 
@@ -467,7 +864,9 @@ bool gamma_new_params(uint32_t width, uint32_t height,
                   uint32_t players, uint32_t areas){
   return !(width < 1
         || height < 1
+        || (uint64_t)width + 2 > UINT64_MAX / ((uint64_t)height + 2)
         || players < 1
+        || players > GAMMA_PLAYERS_MAX
         || areas == 0);
 }
 
@@ -482,329 +881,630 @@ gamma_t* gamma_new(uint32_t width, uint32_t height,
   g->width = width;
   g->height = height;
   g->players = players;
-  if(gamma_alloc_fields(g, players) == false) return NULL;
-  if(gamma_alloc_areas(g, players, areas) == false) return NULL;
-  if(gamma_alloc_board(g, width, height) == false) return NULL;
-  if(gamma_alloc_golden(g, players) == false) return NULL;
-  if(gamma_alloc_parent(g, width, height) == false) return NULL;
-  if(gamma_alloc_rank(g, width, height) == false) return NULL;
-  if(gamma_alloc_low(g, width, height) == false) return NULL;
-  fu_init(g->parent, g->rank, g->width, g->height);
+  g->board_length = (uint64_t)width * height;
+  g->touched_first = UINT64_MAX;
+  if(gamma_alloc_players(g, areas) == false) return NULL;
+  if(gamma_alloc_board(g, width) == false) return NULL;
+  if(gamma_alloc_parent(g) == false) return NULL;
+  if(gamma_alloc_rank(g) == false) return NULL;
+  if(gamma_alloc_blocks(g) == false) return NULL;
+  if(gamma_alloc_changes(g, width, height) == false) return NULL;
+  if(gamma_alloc_area_registry(g) == false) return NULL;
 
   return g;
 }
 
+/* @brief Zeruje tablice planszy w zakresie pól, które mogły zostać zmienione.
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
+ */
+void gamma_clear_touched(gamma_t *g){
+  if(g->touched_first > g->touched_last) return;
+  uint64_t first = g->touched_first;
+  uint64_t count = g->touched_last - first + 1;
+  memset(g->board + first, 0, count * sizeof(uint32_t));
+  memset(g->parent + first, 0, count * sizeof(uint64_t));
+  memset(g->rank + first, 0, count * sizeof(uint32_t));
+  //krawędzie pól z zakresu są zapisane przy polach z zakresu (border_touch)
+  memset(g->tree_up + first, 0, count * sizeof(uint8_t));
+  memset(g->block_h + first, 0, count * sizeof(uint64_t));
+  memset(g->block_v + first, 0, count * sizeof(uint64_t));
+  memset(g->block_mark + first, 0, count * sizeof(uint64_t));
+  memset(g->area_index + first, 0, count * sizeof(uint32_t));
+  g->touched_first = UINT64_MAX;
+  g->touched_last = 0;
+}
+
+/* @brief Przenosi wszystkie kubełki klasyfikacji do puli nieużywanych.
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
+ */
+void standings_clear(gamma_t *g){
+  while(g->standings != NULL){
+    gamma_bucket_t *bucket = g->standings;
+    g->standings = bucket->next;
+    bucket->next = g->free_buckets;
+    g->free_buckets = bucket;
+    g->free_buckets_count++;
+  }
+  g->standings_last = NULL;
+}
+
+bool gamma_reset(gamma_t *g, uint32_t players, uint32_t areas){
+  if(g == NULL
+  || !gamma_new_params(g->width, g->height, players, areas)){
+    return false;
+  }
+  gamma_clear_touched(g);
+  standings_clear(g);
+  rect_trees_clear(g);
+  memset(g->active_slots, 0, ((uint64_t)g->active_mask + 1)*sizeof(uint32_t));
+  g->active_count = 0;
+  g->players = players;
+  g->areas = areas;
+  g->busy_fields_all = 0;
+  g->limited_players = 0;
+  g->board_length = (uint64_t)g->width * g->height;
+  g->version = 0;
+  g->mobility_valid = false;
+  g->mobility_golden = false;
+  g->golden_total = 0;
+  g->mobile_count = 0;
+  g->inactive_mobile = false;
+  memset(&g->stats, 0, sizeof(g->stats));
+  return true;
+}
+
+bool gamma_restore(gamma_t *g, uint32_t areas, const uint32_t *golden,
+                   uint32_t count){
+  if(g == NULL || areas == 0 || g->areas != UINT32_MAX
+  || (golden == NULL && count > 0)){
+    return false;
+  }
+  uint32_t limited = 0;
+  for(uint32_t i = 0; i < g->active_count; i++){
+    if(g->active[i].used_areas > areas) return false;
+    if(g->active[i].used_areas == areas) limited++;
+  }
+  for(uint32_t i = 0; i < count; i++){
+    if(golden[i] < 1 || golden[i] > g->players) return false;
+    gamma_player_t *state = player_get(g, golden[i]);
+    if(state == NULL) return false;
+    state->is_golden_used = true;
+  }
+  g->areas = areas;
+  g->limited_players = limited;
+  g->mobility_valid = false;
+  memset(&g->stats, 0, sizeof(g->stats));
+  return true;
+}
+
+/* @brief Zwiększa wersję gry i zapisuje zmianę pola w dzienniku zmian.
+ * Jeśli dziennik jest pełny, nadpisuje najstarszą zmianę.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] x       – współrzędna x-owa pola,
+ * @param[in] y       – współrzędna y-owa pola,
+ * @param[in] player  – gracz, którego pionek stoi teraz na polu.
+ */
+void gamma_record_change(gamma_t *g, uint32_t x, uint32_t y, uint32_t player){
+  g->version++;
+  gamma_change_t *change = &g->changes[g->version % g->changes_size];
+  change->version = g->version;
+  change->x = x;
+  change->y = y;
+  change->player = player;
+}
+
 /* @brief Zlicza ile pól zajętych przez gracza @p player jest obok pola
- * Dla każdego pola będącego w sąsiedzctwie z polem [x][y]
+ * Dla każdego pola będącego w sąsiedzctwie z polem @p i
  * sprawdza, czy jest ono zajęte przez gracza @p player.
  * Jeśli tak, to dodaje jeden do wyniku
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  * @param[in] player  – gracz, którego pól szukamy,
- * @param[in] x       – współrzędna x-owa pola,
- * @param[in] y       – wysokość y-owa pola.
+ * @param[in] i       – indeks pola.
  * @return Licza sąsiednich pól zajętych przez @p player
  */
-uint32_t number_of_fields_next_to(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
-  if(g->board[x][y] != 0) return 0;
+uint32_t number_of_fields_next_to(gamma_t *g, uint32_t player, uint64_t i){
+  if(g->board[i] != 0) return 0;
   uint32_t to_return = 0;
-  if(x != 0 && g->board[x-1][y] == player) to_return++;
-  if(x != g->width - 1 && g->board[x+1][y] == player) to_return++;
-  if(y != 0 && g->board[x][y-1] == player) to_return++;
-  if(y != g->height - 1 && g->board[x][y+1] == player) to_return++;
+  for(uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++)
+    if(g->board[i + g->neighbour[k]] == player) to_return++;
   return to_return;
 }
 
-/* @brief Aktualizuje fields_next_to[x][y] po ruchu na pole [x][y]
+/* @brief Aktualizuje fields_next_to po ruchu na pole @p i
  * Jeśli wartość @p add jest równa @p false, to ruch traktowany jest jako
- * "ujemny" – polega na zdjęciu z pola [x][y] pionka gracza,
+ * "ujemny" – polega na zdjęciu z pola @p i pionka gracza,
  * który stoi na tym polu.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] x       – współrzędna x-owa pola,
- * @param[in] y       – wysokość y-owa pola,
- * @param[in] add     – zmienna, która określa, czy na pole [x][y] postawiono.
+ * @param[in] i       – indeks pola,
+ * @param[in] add     – zmienna, która określa, czy na pole @p i postawiono.
  *                      przed chwilą pionek, czy za chwilę z tego pola pionek
  *                      zostanie zdjęty.
  */
-void update_this_fields_next_to(gamma_t *g, uint32_t x, uint32_t y, bool add){
+void update_this_fields_next_to(gamma_t *g, uint64_t i, bool add){
   uint64_t sign;
   if(add == true) sign = +1;
   else sign = -1;
-  uint32_t player = g->board[x][y];
+  uint32_t player = g->board[i];
+  gamma_player_t *state = player_find(g, player);
 
-  if(x != 0 && g->board[x - 1][y] == 0
-  && number_of_fields_next_to(g, player, x - 1, y) == 1){
-    g->fields_next_to[player - 1] += sign;
-  }
-  if(x != g->width - 1 && g->board[x + 1][y] == 0
-  && number_of_fields_next_to(g, player, x + 1, y) == 1){
-    g->fields_next_to[player - 1] += sign;
-  }
-  if(y != 0 && g->board[x][y - 1] == 0
-  && number_of_fields_next_to(g, player, x, y - 1) == 1){
-    g->fields_next_to[player - 1] += sign;
-  }
-  if(y != g->height - 1 && g->board[x][y + 1] == 0
-  && number_of_fields_next_to(g, player, x, y + 1) == 1){
-    g->fields_next_to[player - 1] += sign;
+  for(uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++){
+    uint64_t n = i + g->neighbour[k];
+    if(g->board[n] == 0 && number_of_fields_next_to(g, player, n) == 1)
+      state->fields_next_to += sign;
   }
 }
 
-/* @brief Aktualizuje fields_next_to pól obok pola [x][y] po ruchu na [x][y].
+/* @brief Aktualizuje fields_next_to pól obok pola @p i po ruchu na @p i.
  * Jeśli wartość @p add jest równa @p false, to ruch traktowany jest jako
- * "ujemny" – polega na zdjęciu z pola [x][y] pionka gracza,
+ * "ujemny" – polega na zdjęciu z pola @p i pionka gracza,
  * który stoi na tym polu.
+ * Każdy sąsiadujący gracz liczony jest raz.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] x       – współrzędna x-owa pola,
- * @param[in] y       – wysokość y-owa pola,
- * @param[in] add     – zmienna, która określa, czy na pole [x][y] postawiono.
+ * @param[in] i       – indeks pola,
+ * @param[in] add     – zmienna, która określa, czy na pole @p i postawiono.
  *                      przed chwilą pionek, czy za chwilę z tego pola pionek
  *                      zostanie zdjęty.
  */
-void update_around_fields_next_to(gamma_t *g, uint32_t x, uint32_t y, bool add){
+void update_around_fields_next_to(gamma_t *g, uint64_t i, bool add){
   uint64_t sign;
   if(add == true) sign = +1;
   else sign = -1;
 
-  if(x != 0 && g->board[x - 1][y] != 0){
-    g->fields_next_to[g->board[x - 1][y] - 1] -= sign;
-  }
-  if(x != g->width - 1 && g->board[x + 1][y] != 0
-  && (x == 0 || g->board[x - 1][y] != g->board[x + 1][y])){
-    g->fields_next_to[g->board[x + 1][y] - 1] -= sign;
-  }
-  if(y != 0 && g->board[x][y - 1] != 0
-  && (x == 0 || g->board[x - 1][y] != g->board[x][y - 1])
-  && (x == g->width - 1 || g->board[x + 1][y] != g->board[x][y - 1])){
-    g->fields_next_to[g->board[x][y - 1] - 1] -= sign;
-  }
-  if(y != g->height - 1 && g->board[x][y + 1] != 0
-  && (x == 0 || g->board[x - 1][y] != g->board[x][y + 1])
-  && (x == g->width - 1 || g->board[x + 1][y] != g->board[x][y + 1])
-  && (y == 0 || g->board[x][y - 1] != g->board[x][y + 1])){
-    (g->fields_next_to)[g->board[x][y + 1] - 1] -= sign;
+  for(uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++){
+    uint32_t owner = g->board[i + g->neighbour[k]];
+    if(owner == 0 || owner == GAMMA_BORDER) continue;
+    bool counted = false;
+    for(uint32_t j = 0; j < k; j++)
+      if(g->board[i + g->neighbour[j]] == owner) counted = true;
+    if(!counted) player_find(g, owner)->fields_next_to -= sign;
   }
 }
 
-/* @brief Zlicza ile pól dookoła [x][y] należy do gracza @p player
+/* @brief Zlicza ile pól dookoła pola @p i należy do gracza @p player
+* Łączy obszary tych pól z polem @p i, a krawędzie do nich dodaje do lasu
+* rozpinającego i bloków obszarów.
 * @param[in] g       – wskaźnik na strukturę gamma_t,
 * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
 *                      @p players z funkcji @ref gamma_new,
-* @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
-*                      @p width z funkcji @ref gamma_new,
-* @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
-*                      @p height z funkcji @ref gamma_new.
-*                      zostanie zdjęty.
+* @param[in] i       – indeks pola.
 * @return Licza sąsiednich pól zajętych przez gracza @p player
 */
-uint32_t get_various_areas(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
+uint32_t get_various_areas(gamma_t *g, uint32_t player, uint64_t i){
   uint32_t to_return = 0;
-  pair_t* xy_0_0 = fu_find(g->parent, &(g->parent[x][y]));
-  if(x != 0 && g->board[x - 1][y] == player){
-    pair_t* xy_m_0 = fu_find(g->parent, &(g->parent[x - 1][y]));
-    if(equal(*xy_0_0, *xy_m_0) == false) to_return++;
-    fu_union(g->parent, g->rank, xy_0_0, xy_m_0);
-  }
-  if(x != g->width - 1 && g->board[x + 1][y] == player){
-    pair_t* xy_p_0 = fu_find(g->parent, &(g->parent[x + 1][y]));
-    if(equal(*xy_0_0, *xy_p_0) == false) to_return++;
-    fu_union(g->parent, g->rank, xy_0_0, xy_p_0);
-  }
-  if(y != 0 && g->board[x][y - 1] == player){
-    pair_t* xy_0_m = fu_find(g->parent, &(g->parent[x][y - 1]));
-    if(equal(*xy_0_0, *xy_0_m) == false) to_return++;
-    fu_union(g->parent, g->rank, xy_0_0, xy_0_m);
-  }
-  if(y != g->height - 1 && g->board[x][y + 1] == player){
-    pair_t* xy_0_p = fu_find(g->parent, &(g->parent[x][y + 1]));
-    if(equal(*xy_0_0, *xy_0_p) == false) to_return++;
-    fu_union(g->parent, g->rank, xy_0_0, xy_0_p);
+  gamma_player_t *state = player_find(g, player);
+  g->tree_up[i] = 0;
+  for(uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++){
+    uint64_t n = i + g->neighbour[k];
+    if(g->board[n] != player) continue;
+    //reprezentant pola i mógł się zmienić przy poprzednim połączeniu
+    if(fu_find(g, i) != fu_find(g, n)){
+      to_return++;
+      block_link(g, state, i, k);
+    }
+    else{
+      block_merge_path(g, i, n);
+    }
+    fu_union(g, state, i, n);
   }
   return to_return;
 }
 
-bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
+/* @brief Zmienia liczbę obszarów zajmowanych przez gracza.
+ * Aktualizuje liczbę graczy zajmujących maksymalną liczbę obszarów.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza,
+ * @param[in] delta   – zmiana liczby obszarów.
+ */
+void used_areas_add(gamma_t *g, gamma_player_t *state, int64_t delta){
+  if(state->used_areas == g->areas) g->limited_players--;
+  state->used_areas += delta;
+  if(state->used_areas == g->areas) g->limited_players++;
+}
+
+/* @brief Zapewnia, że jest co najmniej @p count nieużywanych kubełków.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] count   – potrzebna liczba kubełków.
+ * @return Wartość @p true jeśli alokacja powiodła się,
+ * a @p false w przeciwnym razie.
+ */
+bool standings_reserve(gamma_t *g, uint32_t count){
+  while(g->free_buckets_count < count){
+    gamma_bucket_t *bucket = malloc(sizeof(gamma_bucket_t));
+    if(bucket == NULL) return false;
+    bucket->next = g->free_buckets;
+    g->free_buckets = bucket;
+    g->free_buckets_count++;
+  }
+  return true;
+}
+
+/* @brief Wstawia nowy kubełek do listy kubełków.
+ * Kubełek pobierany jest z puli nieużywanych (@ref standings_reserve).
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] busy    – liczba pól graczy kubełka,
+ * @param[in] prev    – kubełek, po którym wstawiany jest nowy, lub NULL,
+ *                      jeśli nowy ma być pierwszy,
+ * @param[in] next    – kubełek, przed którym wstawiany jest nowy, lub NULL.
+ * @return Wstawiony kubełek.
+ */
+gamma_bucket_t* standings_insert_bucket(gamma_t *g, uint64_t busy,
+                                        gamma_bucket_t *prev,
+                                        gamma_bucket_t *next){
+  gamma_bucket_t *bucket = g->free_buckets;
+  g->free_buckets = bucket->next;
+  g->free_buckets_count--;
+  bucket->busy = busy;
+  bucket->first = 0;
+  bucket->prev = prev;
+  bucket->next = next;
+  if(prev != NULL) prev->next = bucket;
+  else g->standings = bucket;
+  if(next != NULL) next->prev = bucket;
+  else g->standings_last = bucket;
+  return bucket;
+}
+
+/* @brief Usuwa gracza z jego kubełka.
+ * Pusty kubełek wraca do puli nieużywanych.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza, który należy do kubełka.
+ */
+void standings_unlink(gamma_t *g, gamma_player_t *state){
+  gamma_bucket_t *bucket = state->bucket;
+  uint32_t next = state->standings_next;
+  uint32_t prev = state->standings_prev;
+  if(prev != 0) player_find(g, prev)->standings_next = next;
+  else bucket->first = next;
+  if(next != 0) player_find(g, next)->standings_prev = prev;
+  state->bucket = NULL;
+  if(bucket->first != 0) return;
+
+  if(bucket->prev != NULL) bucket->prev->next = bucket->next;
+  else g->standings = bucket->next;
+  if(bucket->next != NULL) bucket->next->prev = bucket->prev;
+  else g->standings_last = bucket->prev;
+  bucket->next = g->free_buckets;
+  g->free_buckets = bucket;
+  g->free_buckets_count++;
+}
+
+/* @brief Dopisuje gracza na początek kubełka.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza, który nie należy do żadnego kubełka,
+ * @param[in] bucket  – kubełek.
+ */
+void standings_link(gamma_t *g, gamma_player_t *state, gamma_bucket_t *bucket){
+  state->standings_prev = 0;
+  state->standings_next = bucket->first;
+  if(bucket->first != 0)
+    player_find(g, bucket->first)->standings_prev = state->player;
+  bucket->first = state->player;
+  state->bucket = bucket;
+}
+
+/* @brief Przenosi gracza do kubełka o liczbie pól większej o jeden.
+ * Wywoływana po zwiększeniu busy_fields gracza. Zużywa najwyżej jeden
+ * nieużywany kubełek.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza.
+ */
+void standings_increment(gamma_t *g, gamma_player_t *state){
+  uint64_t busy = state->busy_fields;
+  gamma_bucket_t *bucket = state->bucket;
+  //sąsiednie kubełki: prev ma co najmniej busy pól, next – mniej niż busy
+  gamma_bucket_t *prev = (bucket != NULL) ? bucket->prev : g->standings_last;
+  gamma_bucket_t *next = bucket;
+  gamma_bucket_t *target = (prev != NULL && prev->busy == busy)
+                           ? prev : standings_insert_bucket(g, busy, prev, next);
+  if(bucket != NULL) standings_unlink(g, state);
+  standings_link(g, state, target);
+}
+
+/* @brief Przenosi gracza do kubełka o liczbie pól mniejszej o jeden.
+ * Wywoływana po zmniejszeniu busy_fields gracza. Gracz bez pól nie należy
+ * do żadnego kubełka. Zużywa najwyżej jeden nieużywany kubełek.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza.
+ */
+void standings_decrement(gamma_t *g, gamma_player_t *state){
+  uint64_t busy = state->busy_fields;
+  gamma_bucket_t *bucket = state->bucket;
+  if(busy == 0){
+    standings_unlink(g, state);
+    return;
+  }
+  gamma_bucket_t *target = (bucket->next != NULL && bucket->next->busy == busy)
+                           ? bucket->next
+                           : standings_insert_bucket(g, busy, bucket,
+                                                     bucket->next);
+  standings_unlink(g, state);
+  standings_link(g, state, target);
+}
+
+/* @brief Ustawia pola ramki sąsiadujące z polem (x, y).
+ * Plansza alokowana jest bez ramki, więc przed zajęciem pola przy brzegu
+ * planszy jego sąsiedzi z ramki dostają wartość @ref GAMMA_BORDER.
+ * Pola ramki obok wolnych pól mogą pozostać zerami – są sprawdzane tylko
+ * przy porównaniu z numerem gracza.
+ * Poszerza zakres pól, które mogły zostać zmienione, o pole (x, y)
+ * i jego sąsiadów.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] x       – współrzędna x-owa pola,
+ * @param[in] y       – współrzędna y-owa pola.
+ */
+void border_touch(gamma_t *g, uint32_t x, uint32_t y){
+  uint64_t i = cell(g, x, y);
+  if(x == 0) g->board[i - 1] = GAMMA_BORDER;
+  if(x == g->width - 1) g->board[i + 1] = GAMMA_BORDER;
+  if(y == 0) g->board[i - g->stride] = GAMMA_BORDER;
+  if(y == g->height - 1) g->board[i + g->stride] = GAMMA_BORDER;
+  if(g->touched_first > i - g->stride) g->touched_first = i - g->stride;
+  if(g->touched_last < i + g->stride) g->touched_last = i + g->stride;
+}
+
+/* @brief Wykonuje ruch bez aktualizowania liczników ruchów.
+ * Parametry i wynik są takie same jak w @ref gamma_move.
+ */
+bool gamma_make_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
   if(g == NULL
   || (player == 0 || player > g->players)
   || x > g->width - 1
   || y > g->height - 1
-  || g->board[x][y] != 0){
+  || g->board[cell(g, x, y)] != 0){
+    return false;
+  }
+  gamma_player_t *state = player_get(g, player);
+  if(state == NULL
+  || !area_reserve(state, 1)
+  || !standings_reserve(g, 2)){
     return false;
   }
 
-  uint32_t various_areas = get_various_areas(g, player, x, y);
+  uint64_t i = cell(g, x, y);
+  border_touch(g, x, y);
+  uint32_t various_areas = get_various_areas(g, player, i);
   //nie zwiększa się liczba obszarów zajętych przez gracza player
   if(various_areas > 0){
-    g->board[x][y] = player;
-    update_around_fields_next_to(g, x, y, true);
-    update_this_fields_next_to(g, x, y, true);
-    g->busy_fields[player - 1]++;
+    g->board[i] = player;
+    update_around_fields_next_to(g, i, true);
+    update_this_fields_next_to(g, i, true);
+    state->busy_fields++;
+    standings_increment(g, state);
     g->busy_fields_all++;
-    g->used_areas[player - 1] -= (various_areas - 1);
-    low_set_not_up_to_date(g, x, y);
+    g->board_length += board_cell_length(player) - 1;
+    gamma_record_change(g, x, y, player);
+    if(g->rect_tree_count > 0) rect_trees_add(g, x, y, player, 1);
+    used_areas_add(g, state, -(int64_t)(various_areas - 1));
     return true;
   }
   //zwiększa się liczba obszarów zajętych przez gracza player
   else{
-    if(g->used_areas[player - 1] == g->areas){
+    if(state->used_areas == g->areas){
       return false;
     }
-    g->board[x][y] = player;
-    update_around_fields_next_to(g, x, y, true);
-    update_this_fields_next_to(g, x, y, true);
-    g->busy_fields[player - 1]++;
+    g->board[i] = player;
+    update_around_fields_next_to(g, i, true);
+    update_this_fields_next_to(g, i, true);
+    state->busy_fields++;
+    standings_increment(g, state);
     g->busy_fields_all++;
-    g->used_areas[player - 1]++;
-    g->parent[x][y] = make_pair(x, y);
-    low_set_not_up_to_date(g, x, y);
+    g->board_length += board_cell_length(player) - 1;
+    gamma_record_change(g, x, y, player);
+    if(g->rect_tree_count > 0) rect_trees_add(g, x, y, player, 1);
+    used_areas_add(g, state, 1);
+    fu_set_parent(g, i, i);
+    area_add(g, state, i, 1);
     return true;
   }
 }
 
+bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
+  bool moved = gamma_make_move(g, player, x, y);
+  if(g != NULL){
+    STATS_ADD(g, moves, 1);
+    STATS_ADD(g, moves_accepted, moved);
+  }
+  return moved;
+}
+
+uint32_t gamma_owner(gamma_t *g, uint32_t x, uint32_t y){
+  if(g == NULL || x >= g->width || y >= g->height) return 0;
+  return g->board[cell(g, x, y)];
+}
+
 uint64_t gamma_busy_fields(gamma_t *g, uint32_t player){
   if(g == NULL
   || (1 > player || player > g->players)){
     return 0;
   }
-  return g->busy_fields[player - 1];
+  return player_view(g, player)->busy_fields;
 }
 
 /* @brief Odtwarza strukturę find and union dla danej obszaru
  * Dla każdego pola należącego do obszaru:
  * – ustawia wartość w tablicy ojcostwa @p parent na @p ancestor.
  * – poprawia tablicę rang @p rank.
+ * – jeśli @p ancestor to nie @ref FU_NONE, odtwarza drzewo rozpinające
+ *   obszaru o korzeniu @p ancestor i jego bloki (@ref block_insert).
  * @param[in] g         – wskaźnik na strukturę gamma_t,
- * @param[in] x         – współrzędna x-owa pola,
- * @param[in] y         – wysokość y-owa pola,
- * @param[in] ancestor  – nowy reprezentant spójnej,
- *                        do której należy pole [x][y]
- */
-void gamma_fu_recreate(gamma_t *g, uint32_t x, uint32_t y, pair_t ancestor){
-  if(!equal(make_pair(x, y), ancestor)) g->rank[x][y] = 0;
-  if(!equal((g->parent[x][y]), ancestor)){
-    g->parent[x][y] = ancestor;
-    if(x != 0 && g->board[x][y] == g->board[x-1][y])
-      gamma_fu_recreate(g, x-1, y, ancestor);
-    if(x != g->width - 1 && g->board[x][y] == g->board[x+1][y])
-      gamma_fu_recreate(g, x+1, y, ancestor);
-    if(y != 0 && g->board[x][y] == g->board[x][y-1])
-      gamma_fu_recreate(g, x, y-1, ancestor);
-    if(y != g->height - 1 && g->board[x][y] == g->board[x][y+1])
-      gamma_fu_recreate(g, x, y+1, ancestor);
-  }
-}
-
-
-/* @brief Liczy ile nowych obszarów powstanie po usunięciu pola [x][y]
- * @param[in] g                 – wskaźnik na strukturę gamma_t,
- * @param[in] x                 – współrzędna x-owa pola,
- * @param[in] y                 – wysokość y-owa pola,
- * @param[in] previous_player   – gracz, którego pionek został usunięty.
- * @return Liczba obszarów, które powstaną.
+ * @param[in] i         – indeks pola,
+ * @param[in] ancestor  – nowy reprezentant spójnej, do której należy pole
+ *                        @p i, lub @ref FU_NONE
+ * @param[in] up        – numer sąsiada, od którego przyszło wywołanie,
+ *                        plus jeden, lub 0 dla pola @p ancestor.
+ * @return Liczba pól, którym zmieniono wartość w tablicy @p parent.
  */
-
-pair_t number_of_neighbours_and_bridges(gamma_t *g, uint32_t x, uint32_t y){
-  uint32_t neighbours = 0, bridges = 0;
-  if(x != 0 && g->board[x - 1][y] == g->board[x][y]){
-    neighbours++;
-    if(low_bridge(g, x, y, x - 1, y)) bridges++;
-  }
-  if(x != g->width - 1 && g->board[x + 1][y] == g->board[x][y]){
-    neighbours++;
-    if(low_bridge(g, x, y, x + 1, y)) bridges++;
-  }
-  if(y != 0 && g->board[x][y - 1] == g->board[x][y]){
-    neighbours++;
-    if(low_bridge(g, x, y, x, y - 1)) bridges++;
-  }
-  if(y != g->height - 1 && g->board[x][y + 1] == g->board[x][y]){
-    neighbours++;
-    if(low_bridge(g, x, y, x, y + 1)) bridges++;
-  }
-  return make_pair(neighbours, bridges);
-}
-
-uint64_t number_of_new_areas(gamma_t *g, uint32_t x, uint32_t y){
-  uint64_t visit_time = 0;
-  low_clear(g, x, y);
-  low_compute(g, x, y, &visit_time);
-  pair_t neighbours_and_bridges = number_of_neighbours_and_bridges(g, x, y);
-  uint32_t neighbours = neighbours_and_bridges.st;
-  uint32_t bridges = neighbours_and_bridges.nd;
-  if(neighbours == bridges){
-    return bridges;
-  }else{
-    if(neighbours == 4 && bridges == 0){
-      if(low_articulation_point(g, x, y)) return 2;
-      else return 1;
-    }else{
-      return bridges + 1;
+uint64_t gamma_fu_recreate(gamma_t *g, uint64_t i, uint64_t ancestor,
+                           uint8_t up){
+  STATS_ADD(g, fu_recreate_cells, 1);
+  uint64_t changed = 0;
+  uint64_t link = (i == ancestor) ? 0 : ancestor;
+  if(i != ancestor) g->rank[i] = 0;
+  if(g->parent[i] != link){
+    g->parent[i] = link;
+    if(ancestor != FU_NONE) block_insert(g, i, up);
+    changed = 1;
+    for(uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++){
+      uint64_t n = i + g->neighbour[k];
+      if(g->board[i] == g->board[n])
+        changed += gamma_fu_recreate(g, n, ancestor, (uint8_t)((k ^ 1) + 1));
     }
   }
+  return changed;
+}
+
+
+/* @brief Podaje układ pól pierścienia 3x3 zajętych przez właściciela pola.
+ * Pola ramki nie należą do żadnego gracza, więc pola przy brzegu planszy
+ * nie wymagają osobnego traktowania.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola.
+ * @return Maska, w której bit k jest ustawiony, jeśli pole i + ring[k]
+ * należy do właściciela pola @p i.
+ */
+uint32_t ring_mask(gamma_t *g, uint64_t i){
+  uint32_t mask = 0;
+  for(uint32_t k = 0; k < GAMMA_RING; k++)
+    if(g->board[i + g->ring[k]] == g->board[i]) mask |= 1u << k;
+  return mask;
 }
 
-void gamma_fu_recreate_neighbours(gamma_t *g, uint32_t x, uint32_t y,
+/* @brief Liczy ile obszarów powstanie z obszaru pola @p i po usunięciu go.
+ * Jeśli sąsiedzi pola łączą się w pierścieniu 3x3, wynik wynika z samego
+ * pierścienia (@ref RING_GROUPS). W przeciwnym razie jest to liczba bloków
+ * obszaru, do których należy pole (@ref block_count).
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] i       – indeks pola.
+ * @return Liczba obszarów, które powstaną.
+ */
+uint64_t number_of_new_areas(gamma_t *g, uint64_t i){
+  STATS_ADD(g, new_areas_calls, 1);
+  uint8_t groups = RING_GROUPS[ring_mask(g, i)];
+  if(groups <= 1){
+    STATS_ADD(g, new_areas_local, 1);
+    return groups;
+  }
+  return block_count(g, i);
+}
+
+/* @brief Odtwarza strukturę find and union obszarów sąsiadujących z @p i.
+ * Wywoływana po zdjęciu z pola @p i pionka gracza @p previous_player.
+ * Reprezentantem każdego z powstałych obszarów zostaje jego pole sąsiadujące
+ * z @p i. Obszary te dodaje do rejestru obszarów @p previous_player.
+ * @param[in] g               – wskaźnik na strukturę gamma_t,
+ * @param[in] i               – indeks pola,
+ * @param[in] previous_player – gracz, którego pionek został zdjęty.
+ */
+void gamma_fu_recreate_neighbours(gamma_t *g, uint64_t i,
                                   uint32_t previous_player){
-  if(x != 0 && g->board[x - 1][y] == previous_player){
-    gamma_fu_recreate(g, x - 1, y, make_pair(-1, -1));
-    gamma_fu_recreate(g, x - 1, y, make_pair(x - 1, y));
-    low_set_not_up_to_date(g, x - 1, y);
-  }
-  if(x != g->width - 1 && g->board[x + 1][y] == previous_player){
-    gamma_fu_recreate(g, x + 1, y, make_pair(-1, -1));
-    gamma_fu_recreate(g, x + 1, y, make_pair(x + 1, y));
-    low_set_not_up_to_date(g, x + 1, y);
-  }
-  if(y != 0 && g->board[x][y - 1] == previous_player){
-    gamma_fu_recreate(g, x, y - 1, make_pair(-1, -1));
-    gamma_fu_recreate(g, x, y - 1, make_pair(x, y - 1));
-    low_set_not_up_to_date(g, x, y - 1);
-  }
-  if(y != g->height - 1 && g->board[x][y + 1] == previous_player){
-    gamma_fu_recreate(g, x, y + 1, make_pair(-1, -1));
-    gamma_fu_recreate(g, x, y + 1, make_pair(x, y + 1));
-    low_set_not_up_to_date(g, x, y + 1);
+  uint64_t roots[GAMMA_NEIGHBOURS];
+  uint64_t sizes[GAMMA_NEIGHBOURS];
+  uint32_t count = 0;
+  for(uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++){
+    uint64_t n = i + g->neighbour[k];
+    if(g->board[n] != previous_player) continue;
+    gamma_fu_recreate(g, n, FU_NONE, 0);
+    sizes[count] = gamma_fu_recreate(g, n, n, 0);
+    roots[count++] = n;
+  }
+  //obszar odtworzony od kilku sąsiadów ma reprezentanta w ostatnim z nich
+  gamma_player_t *state = player_find(g, previous_player);
+  for(uint32_t k = 0; k < count; k++){
+    if(g->parent[roots[k]] == 0)
+      area_add(g, state, roots[k], sizes[k]);
   }
 }
 
 bool gamma_golden_move_check(gamma_t *g, uint32_t player, uint32_t previous_player,
-                             uint32_t x, uint32_t y, int64_t new_areas){
-  if(g->used_areas[player - 1] == g->areas){
+                             uint64_t i, int64_t new_areas){
+  if(player_view(g, player)->used_areas == g->areas){
     bool next_to_area = false;
-    if(x != 0 && g->board[x - 1][y] == player) next_to_area = true;
-    if(x != g->width - 1 && g->board[x + 1][y] == player) next_to_area = true;
-    if(y != 0 && g->board[x][y - 1] == player) next_to_area = true;
-    if(y != g->height - 1 && g->board[x][y + 1] == player) next_to_area = true;
+    for(uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++)
+      if(g->board[i + g->neighbour[k]] == player) next_to_area = true;
     if(!next_to_area) return false;
   }
-  if(g->used_areas[previous_player - 1] + new_areas > g->areas) return false;
+  if(player_view(g, previous_player)->used_areas + new_areas > g->areas)
+    return false;
 
   return true;
 }
 
-bool gamma_golden_possible(gamma_t *g, uint32_t player){
+bool gamma_golden_possible_cancellable(gamma_t *g, uint32_t player,
+                                       atomic_bool *cancel, bool *result){
+  if(result == NULL) return false;
+  *result = false;
   if(g == NULL
   || 1 > player || player > g->players){
-    return false;
+    return true;
   }
-  if(g->busy_fields_all == g->busy_fields[player - 1]
-  || g->is_golden_used[player - 1] == true){
-    return false;
+  STATS_ADD(g, golden_possible_calls, 1);
+  const gamma_player_t *state = player_view(g, player);
+  if(g->busy_fields_all == state->busy_fields
+  || state->is_golden_used == true){
+    return true;
+  }
+  if(g->mobility_valid && g->mobility_golden
+  && g->mobility_version == g->version){
+    //gracz bez stanu może przejąć każde pole, które da się przejąć
+    *result = state->player != 0 ? state->golden_can : g->golden_total > 0;
+    return true;
   }
 
-  low_update_all(g);
   uint32_t previous_player;
   int64_t new_areas;
-  for(uint32_t x = 0; x < g->width; x++){
-    for(uint32_t y = 0; y < g->height; y++){
-      if(g->board[x][y] == 0) continue;
-      if(g->board[x][y] == player) continue;
-      previous_player = g->board[x][y];
-      new_areas = number_of_new_areas(g, x, y) - 1;
-      if(gamma_golden_move_check(g, player, previous_player, x, y, new_areas))
-        return true;
+  uint64_t scanned = 0;
+  bool possible = false, cancelled = false;
+  for(uint32_t y = 0; y < g->height && !possible && !cancelled; y++){
+    for(uint64_t i = cell(g, 0, y), end = i + g->width; i < end; i++){
+      if(cancel != NULL && atomic_load_explicit(cancel, memory_order_relaxed)){
+        cancelled = true;
+        break;
+      }
+      scanned++;
+      if(g->board[i] == 0) continue;
+      if(g->board[i] == player) continue;
+      previous_player = g->board[i];
+      new_areas = number_of_new_areas(g, i) - 1;
+      if(gamma_golden_move_check(g, player, previous_player, i, new_areas)){
+        possible = true;
+        break;
+      }
     }
   }
-  return false;
+  STATS_ADD(g, golden_possible_cells, scanned);
+  STATS_MAX(g, golden_possible_cells_max, scanned);
+  *result = possible;
+  return !cancelled;
+}
+
+bool gamma_golden_known(gamma_t *g, uint32_t player){
+  if(g == NULL
+  || 1 > player || player > g->players){
+    return true;
+  }
+  const gamma_player_t *state = player_view(g, player);
+  return state->is_golden_used
+      || g->busy_fields_all == state->busy_fields
+      || (g->mobility_valid && g->mobility_golden
+          && g->mobility_version == g->version);
+}
+
+bool gamma_golden_possible(gamma_t *g, uint32_t player){
+  bool possible;
+  gamma_golden_possible_cancellable(g, player, NULL, &possible);
+  return possible;
+}
+
+/* @brief Podaje liczbę pól, na które gracz może wykonać zwykły ruch.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] state   – stan gracza.
+ * @return Liczba pól, jak w @ref gamma_free_fields.
+ */
+uint64_t player_free_fields(gamma_t *g, const gamma_player_t *state){
+  if(state->used_areas != g->areas){
+    return ((uint64_t)g->height) * ((uint64_t)g->width) - g->busy_fields_all;
+  }
+  return state->fields_next_to;
 }
 
 uint64_t gamma_free_fields(gamma_t *g, uint32_t player){
@@ -812,42 +1512,414 @@ uint64_t gamma_free_fields(gamma_t *g, uint32_t player){
   || (1 > player || player > g->players)){
     return 0;
   }
+  return player_free_fields(g, player_view(g, player));
+}
 
-  if(g->used_areas[player - 1] != g->areas){
-    return ((uint64_t)g->height) * ((uint64_t)g->width) - g->busy_fields_all;
+/* @brief Wyznacza dla wszystkich graczy wynik gamma_golden_possible.
+ * Jednym przejściem planszy znajduje pola, które mogą zostać przejęte złotym
+ * ruchem (ich właściciel nie przekroczy limitu obszarów), i zapamiętuje
+ * dla każdego gracza ze stanem, ile takich pól ma oraz czy takie pole innego
+ * gracza leży obok niego, a także łączną liczbę takich pól.
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
+ */
+void gamma_golden_summary(gamma_t *g){
+  uint64_t total = 0;
+  for(uint32_t i = 0; i < g->active_count; i++){
+    g->active[i].golden_cells = 0;
+    g->active[i].golden_next_to = false;
+  }
+
+  for(uint32_t y = 0; y < g->height; y++){
+    for(uint64_t i = cell(g, 0, y), end = i + g->width; i < end; i++){
+      uint32_t owner = g->board[i];
+      if(owner == 0) continue;
+      gamma_player_t *state = player_find(g, owner);
+      int64_t new_areas = number_of_new_areas(g, i) - 1;
+      if(state->used_areas + new_areas > g->areas) continue;
+      state->golden_cells++;
+      total++;
+      for(uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++){
+        uint32_t other = g->board[i + g->neighbour[k]];
+        if(other != owner && other != 0 && other != GAMMA_BORDER)
+          player_find(g, other)->golden_next_to = true;
+      }
+    }
+  }
+
+  g->golden_total = total;
+  for(uint32_t i = 0; i < g->active_count; i++){
+    gamma_player_t *state = &g->active[i];
+    if(state->is_golden_used || g->busy_fields_all == state->busy_fields)
+      state->golden_can = false;
+    else if(state->used_areas != g->areas)
+      state->golden_can = (total - state->golden_cells > 0);
+    else
+      state->golden_can = state->golden_next_to;
   }
-  return g->fields_next_to[player - 1];
 }
 
-bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
+/* @brief Porównuje numery graczy (dla qsort).
+ * @param[in] a       – wskaźnik na pierwszy numer,
+ * @param[in] b       – wskaźnik na drugi numer.
+ * @return Liczba ujemna, zero lub dodatnia, jeśli pierwszy numer jest
+ * odpowiednio mniejszy, równy lub większy od drugiego.
+ */
+int compare_players(const void *a, const void *b){
+  uint32_t pa = *(const uint32_t*)a, pb = *(const uint32_t*)b;
+  return (pa > pb) - (pa < pb);
+}
+
+/* @brief Wyznacza podsumowanie możliwości ruchu graczy dla bieżącej wersji.
+ * Złote ruchy liczone są tylko wtedy, gdy któryś gracz nie ma wolnych pól,
+ * a mógłby jeszcze wykonać złoty ruch. Następnie zapisuje rosnąco w @p mobile
+ * graczy ze stanem, którzy mogą wykonać ruch, a w @p inactive_mobile – czy
+ * mogą go wykonać gracze bez stanu (wszyscy są w tej samej sytuacji).
+ * @param[in] g       – wskaźnik na strukturę gamma_t.
+ */
+void gamma_update_mobility(gamma_t *g){
+  if(g->mobility_valid && g->mobility_version == g->version) return;
+  g->mobility_valid = true;
+  g->mobility_version = g->version;
+  bool inactive = g->active_count < g->players;
+  uint64_t empty = (uint64_t)g->width * g->height - g->busy_fields_all;
+  //gracz bez stanu nie ma wolnych pól tylko przy pełnej planszy
+  bool golden = inactive && empty == 0;
+  for(uint32_t i = 0; i < g->active_count && !golden; i++){
+    gamma_player_t *state = &g->active[i];
+    if(player_free_fields(g, state) == 0
+    && !state->is_golden_used
+    && g->busy_fields_all != state->busy_fields)
+      golden = true;
+  }
+  g->mobility_golden = golden;
+  if(golden) gamma_golden_summary(g);
+
+  g->inactive_mobile = inactive
+                       && (empty > 0 || (golden && g->golden_total > 0));
+  g->mobile_count = 0;
+  for(uint32_t i = 0; i < g->active_count; i++){
+    gamma_player_t *state = &g->active[i];
+    if(player_free_fields(g, state) > 0 || (golden && state->golden_can))
+      g->mobile[g->mobile_count++] = state->player;
+  }
+  qsort(g->mobile, g->mobile_count, sizeof(uint32_t), compare_players);
+}
+
+uint64_t gamma_areas(gamma_t *g, uint32_t player, gamma_area_t *out,
+                     uint64_t cap){
+  if(g == NULL
+  || (1 > player || player > g->players)){
+    return 0;
+  }
+  const gamma_player_t *state = player_view(g, player);
+  for(uint64_t i = 0; i < state->area_count && i < cap; i++)
+    out[i] = state->area_list[i];
+  return state->area_count;
+}
+
+bool gamma_game_over(gamma_t *g){
+  if(g == NULL) return false;
+  if(g->busy_fields_all < (uint64_t)g->width * g->height
+  && g->limited_players < g->players){
+    return false;
+  }
+  return gamma_next_player(g, 1) == 0;
+}
+
+uint32_t gamma_standings(gamma_t *g, gamma_standing_t *out, uint32_t k){
+  if(g == NULL || out == NULL) return 0;
+  uint32_t count = 0;
+  for(gamma_bucket_t *bucket = g->standings; bucket != NULL && count < k;
+      bucket = bucket->next){
+    for(uint32_t p = bucket->first; p != 0 && count < k;
+        p = player_find(g, p)->standings_next){
+      out[count].player = p;
+      out[count].busy = bucket->busy;
+      count++;
+    }
+  }
+  return count;
+}
+
+uint32_t gamma_golden_players(gamma_t *g, uint32_t *out, uint32_t k){
+  if(g == NULL || (out == NULL && k > 0)) return 0;
+  uint32_t count = 0;
+  for(uint32_t i = 0; i < g->active_count; i++){
+    if(!g->active[i].is_golden_used) continue;
+    if(count < k) out[count] = g->active[i].player;
+    count++;
+  }
+  return count;
+}
+
+uint32_t gamma_next_player(gamma_t *g, uint32_t player){
+  if(g == NULL
+  || (1 > player || player > g->players)){
+    return 0;
+  }
+  gamma_update_mobility(g);
+  //pierwszy ruchomy gracz ze stanem po graczu player (cyklicznie)
+  uint32_t low = 0, high = g->mobile_count;
+  while(low < high){
+    uint32_t middle = low + (high - low) / 2;
+    if(g->mobile[middle] <= player) low = middle + 1;
+    else high = middle;
+  }
+  uint32_t next = 0;
+  if(g->mobile_count > 0)
+    next = g->mobile[low < g->mobile_count ? low : 0];
+  if(!g->inactive_mobile) return next;
+
+  //gracz bez stanu znajdzie się po najwyżej active_count krokach
+  uint32_t p = player;
+  do{
+    p = (p == g->players) ? 1 : p + 1;
+  }while(p != next && player_find(g, p) != NULL);
+  return p;
+}
+
+/* @brief Wykonuje złoty ruch bez aktualizowania liczników ruchów.
+ * Parametry i wynik są takie same jak w @ref gamma_golden_move.
+ */
+bool gamma_make_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
   if(g == NULL
   || x > g->width - 1
   || y > g->height - 1
-  || g->board[x][y] == 0
-  || g->board[x][y] == player
+  || g->board[cell(g, x, y)] == 0
+  || g->board[cell(g, x, y)] == player
   || (player == 0 || player > g->players)
-  || g->is_golden_used[player - 1] == true){
+  || player_view(g, player)->is_golden_used == true){
+    return false;
+  }
+  uint64_t i = cell(g, x, y);
+  uint32_t previous_player = g->board[i];
+  int64_t new_areas = number_of_new_areas(g, i) - 1;
+
+  if(!gamma_golden_move_check(g, player, previous_player, i, new_areas))
     return false;
+  gamma_player_t *state = player_get(g, player);
+  //stan poprzedniego gracza pobierany po utworzeniu stanu gracza player
+  gamma_player_t *previous = player_find(g, previous_player);
+  if(state == NULL
+  || !area_reserve(state, 1)
+  || !area_reserve(previous, 3)
+  || !standings_reserve(g, 2)){
+    return false;
+  }
+  area_remove(g, previous, fu_find(g, i));
+  update_this_fields_next_to(g, i, false);
+  update_around_fields_next_to(g, i, false);
+  g->board[i] = 0;
+  g->board_length -= board_cell_length(previous_player) - 1;
+  if(g->rect_tree_count > 0)
+    rect_trees_add(g, x, y, previous_player, (uint64_t)-1);
+
+  gamma_fu_recreate_neighbours(g, i, previous_player);
+  fu_set_parent(g, i, i);
+  gamma_make_move(g, player, x, y);
+
+  used_areas_add(g, previous, new_areas);
+  state->is_golden_used = true;
+  previous->busy_fields--;
+  standings_decrement(g, previous);
+  g->busy_fields_all--;
+  return true;
+}
+
+bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
+  bool moved = gamma_make_golden_move(g, player, x, y);
+  if(g != NULL){
+    STATS_ADD(g, golden_moves, 1);
+    STATS_ADD(g, golden_moves_accepted, moved);
   }
-  uint32_t previous_player = g->board[x][y];
-  int64_t new_areas = number_of_new_areas(g, x, y) - 1;
+  return moved;
+}
+
+uint64_t gamma_version(gamma_t *g){
+  if(g == NULL) return 0;
+  return g->version;
+}
 
-  if(!gamma_golden_move_check(g, player, previous_player, x, y, new_areas)){
+bool gamma_board_diff(gamma_t *g, uint64_t since_version,
+                      gamma_change_t *out, uint64_t cap, uint64_t *count){
+  if(g == NULL
+  || count == NULL
+  || since_version > g->version
+  || g->version - since_version > g->changes_size){
     return false;
   }
-  update_this_fields_next_to(g, x, y, false);
-  update_around_fields_next_to(g, x, y, false);
-  g->board[x][y] = 0;
+  *count = g->version - since_version;
+  for(uint64_t i = 0; i < *count && i < cap; i++)
+    out[i] = g->changes[(since_version + 1 + i) % g->changes_size];
+  return true;
+}
+
+/* @brief Buduje drzewo Fenwicka pól gracza w czasie liniowym.
+ * Najpierw sumuje pola gracza w blokach, a potem przekazuje sumy
+ * do rodziców – wzdłuż wierszy bloków, a następnie całymi wierszami wzdłuż
+ * kolumn.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in,out] tree – drzewo z zaalokowaną tablicą liczników,
+ * @param[in] player  – numer gracza lub 0 dla wszystkich zajętych pól.
+ */
+void rect_tree_build(gamma_t *g, gamma_rect_tree_t *tree, uint32_t player){
+  uint64_t bw = rect_blocks_x(g), bh = rect_blocks_y(g);
+  uint64_t *counts = tree->counts;
+  memset(counts, 0, bw * bh * sizeof(uint64_t));
+  for(uint32_t y = 0; y < g->height; y++){
+    const uint32_t *row = g->board + cell(g, 0, y);
+    uint64_t *out = counts + (uint64_t)(y / GAMMA_RECT_BLOCK) * bw;
+    for(uint32_t x = 0; x < g->width; x += GAMMA_RECT_BLOCK){
+      uint32_t end = g->width - x < GAMMA_RECT_BLOCK ? g->width - x
+                                                     : GAMMA_RECT_BLOCK;
+      uint64_t sum = 0;
+      for(uint32_t k = 0; k < end; k++)
+        sum += player == 0 ? row[x + k] != 0 : row[x + k] == player;
+      out[x / GAMMA_RECT_BLOCK] += sum;
+    }
+  }
+  for(uint64_t y = 0; y < bh; y++){
+    uint64_t *out = counts + y * bw;
+    for(uint64_t k = 1; k <= bw; k++){
+      uint64_t parent = k + (k & -k);
+      if(parent <= bw) out[parent - 1] += out[k - 1];
+    }
+  }
+  for(uint64_t j = 1; j <= bh; j++){
+    uint64_t parent = j + (j & -j);
+    if(parent > bh) continue;
+    uint64_t *out = counts + (parent - 1) * bw;
+    const uint64_t *in = counts + (j - 1) * bw;
+    for(uint64_t x = 0; x < bw; x++) out[x] += in[x];
+  }
+  tree->player = player;
+}
 
-  gamma_fu_recreate_neighbours(g, x, y, previous_player);
-  g->parent[x][y] = make_pair(x, y);
-  gamma_move(g, player, x, y);
+/* @brief Podaje drzewo Fenwicka pól gracza.
+ * Jeśli gracz nie ma drzewa, a zapytania bez drzewa przejrzały już tyle
+ * pól, ile ma plansza, buduje je w wolnym miejscu lub w miejscu drzewa
+ * najdawniej użytego. Wszystkie drzewa zajmują razem nie więcej pamięci
+ * niż tablica pól planszy.
+ * @param[in,out] g   – wskaźnik na strukturę gamma_t,
+ * @param[in] player  – numer gracza lub 0 dla wszystkich zajętych pól.
+ * @return Drzewo lub NULL, jeśli gracz nie ma drzewa i nie opłaca się
+ * go budować, drzewo nie mieści się w pamięci przeznaczonej na drzewa
+ * albo nie udało się zaalokować pamięci.
+ */
+gamma_rect_tree_t* rect_tree_get(gamma_t *g, uint32_t player){
+  uint64_t cells = (uint64_t)g->width * g->height;
+  uint64_t size = rect_blocks_x(g) * rect_blocks_y(g) * sizeof(uint64_t);
+  uint64_t limit = cells * sizeof(uint32_t) / size;
+  if(limit > GAMMA_RECT_TREES) limit = GAMMA_RECT_TREES;
+  gamma_rect_tree_t *tree = NULL;
+  for(uint32_t t = 0; t < g->rect_tree_count && tree == NULL; t++)
+    if(g->rect_trees[t].player == player) tree = &g->rect_trees[t];
+  if(tree == NULL){
+    if(limit == 0 || g->rect_scanned < cells) return NULL;
+    if(g->rect_tree_count < limit){
+      tree = &g->rect_trees[g->rect_tree_count];
+      tree->counts = malloc(size);
+      if(tree->counts == NULL) return NULL;
+      g->rect_tree_count++;
+    }
+    else{
+      tree = &g->rect_trees[0];
+      for(uint32_t t = 1; t < g->rect_tree_count; t++)
+        if(g->rect_trees[t].used < tree->used) tree = &g->rect_trees[t];
+    }
+    rect_tree_build(g, tree, player);
+    g->rect_scanned = 0;
+  }
+  tree->used = ++g->rect_clock;
+  return tree;
+}
 
-  g->used_areas[previous_player - 1] += new_areas;
-  g->is_golden_used[player - 1] = true;
-  g->busy_fields[previous_player - 1]--;
-  g->busy_fields_all--;
+/* @brief Liczy pola zliczane przez drzewo w blokach [0, x) × [0, y).
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] tree    – drzewo,
+ * @param[in] x       – liczba początkowych kolumn bloków,
+ * @param[in] y       – liczba początkowych wierszy bloków.
+ * @return Liczba pól.
+ */
+uint64_t rect_tree_prefix(gamma_t *g, const gamma_rect_tree_t *tree,
+                          uint64_t x, uint64_t y){
+  uint64_t bw = rect_blocks_x(g), sum = 0;
+  for(uint64_t j = y; j > 0; j -= j & -j)
+    for(uint64_t k = x; k > 0; k -= k & -k)
+      sum += tree->counts[(j - 1) * bw + k - 1];
+  return sum;
+}
+
+/* @brief Liczy pola gracza w prostokącie [x0, x1) × [y0, y1) bezpośrednio
+ * na planszy.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] player  – numer gracza lub 0 dla wszystkich zajętych pól,
+ * @param[in] x0      – numer pierwszej kolumny prostokąta,
+ * @param[in] y0      – numer pierwszego wiersza prostokąta,
+ * @param[in] x1      – numer kolumny za prostokątem,
+ * @param[in] y1      – numer wiersza za prostokątem.
+ * @return Liczba pól.
+ */
+uint64_t rect_scan(gamma_t *g, uint32_t player, uint64_t x0, uint64_t y0,
+                   uint64_t x1, uint64_t y1){
+  uint64_t count = 0;
+  for(uint64_t y = y0; y < y1; y++){
+    const uint32_t *row = g->board + cell(g, 0, (uint32_t)y);
+    for(uint64_t x = x0; x < x1; x++)
+      count += player == 0 ? row[x] != 0 : row[x] == player;
+  }
+  return count;
+}
+
+uint64_t gamma_rect_count(gamma_t *g, uint32_t player, uint32_t x0,
+                          uint32_t y0, uint32_t x1, uint32_t y1){
+  if(g == NULL
+  || player > g->players
+  || x0 > x1 || x1 >= g->width
+  || y0 > y1 || y1 >= g->height){
+    return 0;
+  }
+  uint64_t area = (uint64_t)(x1 - x0 + 1) * (y1 - y0 + 1);
+  uint64_t xe = (uint64_t)x1 + 1, ye = (uint64_t)y1 + 1;
+  //pełne bloki prostokąta: [bx0, bx1) × [by0, by1)
+  uint64_t bx0 = ((uint64_t)x0 + GAMMA_RECT_BLOCK - 1) / GAMMA_RECT_BLOCK;
+  uint64_t by0 = ((uint64_t)y0 + GAMMA_RECT_BLOCK - 1) / GAMMA_RECT_BLOCK;
+  uint64_t bx1 = xe / GAMMA_RECT_BLOCK, by1 = ye / GAMMA_RECT_BLOCK;
+  gamma_rect_tree_t *tree = NULL;
+  if(area > RECT_SCAN_MAX && bx0 < bx1 && by0 < by1){
+    tree = rect_tree_get(g, player);
+  }
+  //dla player = 0 liczone są pola zajęte
+  uint64_t count;
+  if(tree != NULL){
+    uint64_t fx0 = bx0 * GAMMA_RECT_BLOCK, fx1 = bx1 * GAMMA_RECT_BLOCK;
+    uint64_t fy0 = by0 * GAMMA_RECT_BLOCK, fy1 = by1 * GAMMA_RECT_BLOCK;
+    count = rect_tree_prefix(g, tree, bx1, by1)
+          - rect_tree_prefix(g, tree, bx0, by1)
+          - rect_tree_prefix(g, tree, bx1, by0)
+          + rect_tree_prefix(g, tree, bx0, by0);
+    count += rect_scan(g, player, x0, y0, xe, fy0)
+           + rect_scan(g, player, x0, fy1, xe, ye)
+           + rect_scan(g, player, x0, fy0, fx0, fy1)
+           + rect_scan(g, player, fx1, fy0, xe, fy1);
+  }
+  else{
+    count = rect_scan(g, player, x0, y0, xe, ye);
+    if(area > RECT_SCAN_MAX) g->rect_scanned += area;
+  }
+  return player == 0 ? area - count : count;
+}
+
+bool gamma_stats(gamma_t *g, gamma_stats_t *out){
+#ifdef GAMMA_STATS
+  if(g == NULL || out == NULL) return false;
+  *out = g->stats;
   return true;
+#else
+  (void)g;
+  (void)out;
+  return false;
+#endif
 }
 
 bool add_letter(uint64_t *index, uint64_t *size, char* *board, char l){
@@ -865,32 +1937,212 @@ bool add_letter(uint64_t *index, uint64_t *size, char* *board, char l){
   return true;
 }
 
-char* gamma_board(gamma_t *g){
-  if(g == NULL) return NULL;
-  uint64_t size = (g->width + 1) * (g->height + 1);
-  char* board = malloc(size * sizeof(char));
-  if(board == NULL) return NULL;
-  uint64_t index = 0;
+/* @brief Podaje długość napisu opisującego pole zajęte przez gracza.
+ * @param[in] player  – numer gracza lub 0 dla wolnego pola.
+ * @return Liczba znaków, jakie zajmuje pole w opisie planszy.
+ */
+uint32_t board_cell_length(uint32_t player){
+  if(player < 10) return 1;
+  uint32_t digits = 2;
+  for(uint32_t p = player / 100; p > 0; p /= 10) digits++;
+  return digits + 2;
+}
+
+/* @brief Zapisuje opis pola zajętego przez gracza.
+ * Wolne pole opisywane jest jako '.', gracze o jednocyfrowych numerach
+ * jako cyfra, a pozostali jako numer otoczony spacjami.
+ * Cyfry przepisywane są parami z tablicy dwucyfrowych liczb.
+ * @param[out] dst    – bufor o rozmiarze co najmniej @ref BOARD_CELL_MAX,
+ * @param[in] player  – numer gracza lub 0 dla wolnego pola.
+ * @return Liczba zapisanych znaków.
+ */
+uint32_t board_format_cell(char *dst, uint32_t player){
+  static const char pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233"
+    "34353637383940414243444546474849505152535455565758596061626364656667"
+    "68697071727374757677787980818283848586878889909192939495969798990";
+  if(player == 0){
+    dst[0] = '.';
+    return 1;
+  }
+  if(player < 10){
+    dst[0] = (char)('0' + player);
+    return 1;
+  }
+  uint32_t length = board_cell_length(player);
+  char *d = dst + length - 1;
+  *d-- = ' ';
+  while(player >= 10){
+    d -= 1;
+    memcpy(d, pairs + 2 * (player % 100), 2);
+    d--;
+    player /= 100;
+  }
+  if(player > 0) *d-- = (char)('0' + player);
+  *d = ' ';
+  return length;
+}
+
+/* @brief Zapisuje kolejny fragment opisu planszy.
+ * Zaczynając od pozycji @p cursor, zapisuje do bufora tyle całych pól
+ * (i znaków końca wiersza), ile się w nim zmieści, i przesuwa kursor.
+ * Wiersze zapisywane są od y = height - 1 do y = 0.
+ * Opis ostatnio zapisanego pola jest pamiętany, więc pola tego samego gracza
+ * stojące obok siebie są kopiowane bez ponownego formatowania.
+ * @param[in] g        – wskaźnik na strukturę gamma_t,
+ * @param[in,out] cursor – pozycja, od której należy kontynuować,
+ * @param[out] dst     – bufor,
+ * @param[in] cap      – rozmiar bufora.
+ * @return Liczba zapisanych znaków.
+ */
+uint64_t board_render(gamma_t *g, pair_t *cursor, char *dst, uint64_t cap){
+  char text[BOARD_CELL_MAX] = {'.'};
+  uint32_t cell_player = 0, cell_length = 1;
+  uint64_t n = 0;
+  while(cursor->nd != UINT32_MAX){
+    const uint32_t *row = g->board + cell(g, 0, cursor->nd);
+    for(uint32_t x = cursor->st; x < g->width; x++){
+      uint32_t player = row[x];
+      if(player != cell_player){
+        cell_length = board_format_cell(text, player);
+        cell_player = player;
+      }
+      if(n + cell_length > cap){
+        cursor->st = x;
+        return n;
+      }
+      if(cell_length == 1) dst[n] = text[0];
+      else memcpy(dst + n, text, cell_length);
+      n += cell_length;
+    }
+    if(n + 1 > cap){
+      cursor->st = g->width;
+      return n;
+    }
+    dst[n++] = '\n';
+    cursor->st = 0;
+    cursor->nd--;
+  }
+  return n;
+}
+
+uint64_t gamma_board_into(gamma_t *g, char *buf, uint64_t cap){
+  if(g == NULL) return 0;
+  uint64_t length = g->board_length + g->height;
+  if(buf == NULL || cap <= length) return length;
+  pair_t cursor = make_pair(0, g->height - 1);
+  board_render(g, &cursor, buf, length);
+  buf[length] = '\0';
+  return length;
+}
+
+bool gamma_board_write(gamma_t *g, FILE *out){
+  if(g == NULL || out == NULL) return false;
+  char chunk[BOARD_CHUNK];
+  pair_t cursor = make_pair(0, g->height - 1);
+  while(cursor.nd != UINT32_MAX){
+    uint64_t n = board_render(g, &cursor, chunk, BOARD_CHUNK);
+    if(fwrite(chunk, 1, n, out) != n) return false;
+  }
+  return true;
+}
+
+/* @brief Zapisuje liczbę dziesiętnie.
+ * @param[out] dst    – bufor o rozmiarze co najmniej 20 znaków,
+ * @param[in] value   – liczba.
+ * @return Liczba zapisanych znaków.
+ */
+uint32_t board_format_number(char *dst, uint64_t value){
+  if(value < 10){
+    dst[0] = (char)('0' + value);
+    return 1;
+  }
+  char digits[20];
+  uint32_t length = 0;
+  do{
+    digits[length++] = (char)('0' + value % 10);
+    value /= 10;
+  }while(value > 0);
+  for(uint32_t i = 0; i < length; i++) dst[i] = digits[length - 1 - i];
+  return length;
+}
 
-  for(uint32_t y = g->height - 1; y < UINT32_MAX; y--){
+/* @brief Zapisuje serię pól w postaci opisanej w @ref gamma_board_rle_write.
+ * @param[out] dst    – bufor o rozmiarze co najmniej @ref BOARD_RUN_MAX,
+ * @param[in] player  – numer gracza lub 0 dla wolnych pól,
+ * @param[in] length  – liczba pól serii,
+ * @param[in] end     – znak zapisywany za serią.
+ * @return Liczba zapisanych znaków.
+ */
+uint32_t board_format_run(char *dst, uint32_t player, uint64_t length,
+                          char end){
+  uint32_t n = board_format_number(dst, player);
+  if(length > 1){
+    dst[n++] = '*';
+    n += board_format_number(dst + n, length);
+  }
+  dst[n++] = end;
+  return n;
+}
+
+/* @brief Szuka końca serii pól gracza w wierszu.
+ * Pola porównywane są blokami po @ref BOARD_RUN_BLOCK, więc długie serie
+ * przeglądane są bez rozgałęzień dla każdego pola.
+ * @param[in] row     – wiersz planszy,
+ * @param[in] x       – numer kolumny, od której zaczyna się szukanie,
+ * @param[in] width   – szerokość planszy,
+ * @param[in] player  – numer gracza lub 0 dla wolnych pól.
+ * @return Numer kolumny pierwszego pola za serią lub @p width.
+ */
+uint32_t board_run_end(const uint32_t *row, uint32_t x, uint32_t width,
+                       uint32_t player){
+  if(x < width && row[x] != player) return x;
+  while(width - x >= BOARD_RUN_BLOCK){
+    uint32_t diff = 0;
+    for(uint32_t k = 0; k < BOARD_RUN_BLOCK; k++) diff |= row[x + k] ^ player;
+    if(diff != 0) break;
+    x += BOARD_RUN_BLOCK;
+  }
+  while(x < width && row[x] == player) x++;
+  return x;
+}
+
+bool gamma_board_rle_write(gamma_t *g, FILE *out){
+  if(g == NULL || out == NULL
+  || fprintf(out, "R %u %u\n", g->width, g->height) < 0){
+    return false;
+  }
+  char chunk[BOARD_CHUNK];
+  uint64_t n = 0, run_length = 0;
+  uint32_t run_player = g->board[cell(g, 0, g->height - 1)];
+  for(uint32_t y = g->height; y-- > 0; ){
+    const uint32_t *row = g->board + cell(g, 0, y);
     for(uint32_t x = 0; x < g->width; x++){
-      if(g->board[x][y] == 0) {
-        if(!add_letter(&index, &size, &board, '.'))return NULL;
-      }else{
-        if(g->board[x][y] > 9 && !add_letter(&index, &size, &board, ' '))
-          return false;
-        for(uint32_t d = 1000 * 1000 * 1000; d > 0; d /= 10 ){
-          if(d > g->board[x][y]) continue;
-          if(!add_letter(&index, &size, &board, '0' + ((g->board[x][y])/d)%10))
-            return NULL;
-        }
-        if(g->board[x][y] > 9 && !add_letter(&index, &size, &board, ' '))
-          return NULL;
+      uint32_t end = board_run_end(row, x, g->width, run_player);
+      run_length += end - x;
+      if((x = end) == g->width) break;
+      if(n + BOARD_RUN_MAX > BOARD_CHUNK){
+        if(fwrite(chunk, 1, n, out) != n) return false;
+        n = 0;
       }
+      n += board_format_run(chunk + n, run_player, run_length, ' ');
+      run_player = row[x];
+      run_length = 1;
     }
-    if(!add_letter(&index, &size, &board, '\n')) return NULL;
   }
-  if(!add_letter(&index, &size, &board, '\0')) return NULL;
-  if(index < size) board = realloc(board, index*sizeof(char));
+  if(n + BOARD_RUN_MAX > BOARD_CHUNK){
+    if(fwrite(chunk, 1, n, out) != n) return false;
+    n = 0;
+  }
+  n += board_format_run(chunk + n, run_player, run_length, '\n');
+  return fwrite(chunk, 1, n, out) == n;
+}
+
+char* gamma_board(gamma_t *g){
+  if(g == NULL) return NULL;
+  uint64_t length = gamma_board_into(g, NULL, 0);
+  char* board = malloc((length + 1) * sizeof(char));
+  if(board == NULL) return NULL;
+  gamma_board_into(g, board, length + 1);
   return board;
 }
@@ -9,13 +9,41 @@
 #ifndef GAMMA_H
 #define GAMMA_H
 
+#ifndef _POSIX_C_SOURCE
 #define _POSIX_C_SOURCE 199309L
+#endif
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <stdio.h>
 
+/** Wartość pól ramki otaczającej planszę. Żaden gracz nie ma tego numeru.
+ */
+#define GAMMA_BORDER UINT32_MAX
+
+/** Największa liczba graczy – numer @ref GAMMA_BORDER jest zarezerwowany.
+ */
+#define GAMMA_PLAYERS_MAX (GAMMA_BORDER - 1)
+
+/** Liczba sąsiadów pola planszy.
+ */
+#define GAMMA_NEIGHBOURS 4
+
+/** Liczba pól pierścienia 3x3 wokół pola planszy.
+ */
+#define GAMMA_RING 8
+
+/** Największa liczba drzew, w których @ref gamma_rect_count liczy pola
+ * graczy. Gdy potrzebne jest kolejne, zastępowane jest najdawniej użyte.
+ */
+#define GAMMA_RECT_TREES 16
+
+/** Długość boku bloku pól, które drzewa @ref gamma_rect_count liczą razem.
+ */
+#define GAMMA_RECT_BLOCK 16
+
 /** @brief Reprezentacja pary
  */
 struct pair {
@@ -24,6 +52,110 @@ struct pair {
 };
 typedef struct pair pair_t;
 
+/** @brief Liczniki operacji wykonanych przez silnik gry.
+ * Liczniki są aktualizowane tylko wtedy, gdy silnik skompilowano
+ * z makrem GAMMA_STATS.
+ */
+struct gamma_stats {
+    uint64_t moves; ///< liczba wywołań gamma_move
+    uint64_t moves_accepted; ///< liczba wykonanych zwykłych ruchów
+    uint64_t golden_moves; ///< liczba wywołań gamma_golden_move
+    uint64_t golden_moves_accepted; ///< liczba wykonanych złotych ruchów
+    uint64_t block_steps; ///< liczba kroków po blokach przy łączeniu bloków
+    uint64_t block_evert_cells; ///< liczba pól na ścieżkach odwracanych przy
+                                ///< łączeniu drzew rozpinających obszarów
+    uint64_t fu_recreate_cells; ///< liczba pól odwiedzonych przez gamma_fu_recreate
+    uint64_t fu_find_calls; ///< liczba wywołań fu_find
+    uint64_t fu_find_depth; ///< suma głębokości ścieżek przejrzanych przez fu_find
+    uint64_t fu_find_depth_max; ///< największa głębokość ścieżki w fu_find
+    uint64_t golden_possible_calls; ///< liczba wywołań gamma_golden_possible
+    uint64_t golden_possible_cells; ///< suma pól przejrzanych przez gamma_golden_possible
+    uint64_t golden_possible_cells_max; ///< najwięcej pól przejrzanych w jednym wywołaniu
+    uint64_t new_areas_calls; ///< liczba sprawdzeń, na ile obszarów podzieli się obszar
+    uint64_t new_areas_local; ///< liczba takich sprawdzeń rozstrzygniętych przez pierścień 3x3
+};
+typedef struct gamma_stats gamma_stats_t;
+
+/** @brief Zmiana jednego pola planszy zapisana w dzienniku zmian.
+ */
+struct gamma_change {
+    uint64_t version; ///< wersja gry, w której pole uzyskało nową wartość
+    uint32_t x; ///< współrzędna x-owa pola
+    uint32_t y; ///< współrzędna y-owa pola
+    uint32_t player; ///< gracz, którego pionek stoi na polu
+};
+typedef struct gamma_change gamma_change_t;
+
+/** @brief Dwuwymiarowe drzewo Fenwicka liczące pola jednego gracza
+ * w blokach @ref GAMMA_RECT_BLOCK × @ref GAMMA_RECT_BLOCK pól planszy.
+ */
+struct gamma_rect_tree {
+    uint32_t player; ///< gracz, którego pola liczy drzewo, lub 0, jeśli
+                     ///< drzewo liczy wszystkie zajęte pola
+    uint64_t used; ///< numer ostatniego zapytania, które użyło drzewa
+    uint64_t *counts; ///< counts[(y - 1) * bw + x - 1], gdzie bw to liczba
+                      ///< bloków w wierszu – liczba pól gracza w blokach
+                      ///< prostokąta o bokach x & -x oraz y & -y, którego
+                      ///< prawy górny róg to blok (x, y) numerowany od jedynki
+};
+typedef struct gamma_rect_tree gamma_rect_tree_t;
+
+/** @brief Obszar gracza zapisany w rejestrze obszarów.
+ */
+struct gamma_area {
+    uint32_t x; ///< współrzędna x-owa reprezentanta obszaru
+    uint32_t y; ///< współrzędna y-owa reprezentanta obszaru
+    uint64_t size; ///< liczba pól obszaru
+};
+typedef struct gamma_area gamma_area_t;
+
+/** @brief Kubełek graczy o tej samej liczbie zajętych pól.
+ * Kubełki tworzą listę uporządkowaną malejąco według liczby pól,
+ * a gracze kubełka – listę zapisaną w polach @p standings_next
+ * i @p standings_prev stanów graczy.
+ */
+struct gamma_bucket {
+    uint64_t busy; ///< liczba pól zajętych przez każdego gracza kubełka
+    uint32_t first; ///< pierwszy gracz kubełka
+    struct gamma_bucket *prev; ///< kubełek o większej liczbie pól lub NULL
+    struct gamma_bucket *next; ///< kubełek o mniejszej liczbie pól lub NULL
+};
+typedef struct gamma_bucket gamma_bucket_t;
+
+/** @brief Pozycja gracza w klasyfikacji.
+ */
+struct gamma_standing {
+    uint32_t player; ///< numer gracza
+    uint64_t busy; ///< liczba pól zajętych przez gracza
+};
+typedef struct gamma_standing gamma_standing_t;
+
+/** @brief Stan gracza, który wykonał już ruch.
+ * Gracze, którzy jeszcze nie wykonali ruchu, nie mają stanu – wszystkie ich
+ * liczniki są zerowe.
+ */
+struct gamma_player {
+    uint32_t player; ///< numer gracza
+    uint32_t used_areas; ///< liczba obszarów, które zajmuje gracz
+    uint64_t fields_next_to; ///< liczba pól bezpośrednio obok gracza
+    uint64_t busy_fields; ///< liczba pól zajętych przez gracza
+    bool is_golden_used; ///< czy gracz wykonał złoty ruch
+
+    gamma_area_t *area_list; ///< obszary gracza
+    uint64_t area_count; ///< liczba obszarów gracza
+    uint64_t area_cap; ///< rozmiar tablicy @p area_list
+
+    gamma_bucket_t *bucket; ///< kubełek gracza lub NULL,
+                            ///< jeśli gracz nie zajmuje pól
+    uint32_t standings_next; ///< następny gracz w kubełku lub 0
+    uint32_t standings_prev; ///< poprzedni gracz w kubełku lub 0
+
+    bool golden_can; ///< czy gracz może wykonać złoty ruch (podsumowanie)
+    bool golden_next_to; ///< pomocnicza: czy obok gracza jest pole do przejęcia
+    uint64_t golden_cells; ///< pomocnicza: liczba pól gracza do przejęcia
+};
+typedef struct gamma_player gamma_player_t;
+
 /** @brief Struktura przechowująca stan gry.
  */
 struct gamma {
@@ -31,22 +163,82 @@ struct gamma {
     uint32_t height; ///< wysokosć planszy, liczba dodatnia
     uint32_t players; ///< liczba graczy, liczba dodatnia
 
-    uint64_t *fields_next_to; ///< liczba pól bezpośrednio obok gracza
-    uint64_t *busy_fields; ///< liczba pól zajętych przez gracza
+    gamma_player_t *active; ///< stany graczy, którzy wykonali ruch
+    uint32_t active_count; ///< liczba stanów w @p active
+    uint32_t active_used; ///< liczba początkowych pozycji @p active, których
+                          ///< tablice area_list należą do gry (także po
+                          ///< @ref gamma_reset), nie mniejsza od active_count
+    uint32_t active_cap; ///< rozmiar tablicy @p active
+    uint32_t *active_slots; ///< tablica haszująca: numer gracza -> pozycja
+                            ///< jego stanu w @p active plus jeden, 0 – puste
+    uint32_t active_mask; ///< rozmiar tablicy @p active_slots minus jeden
     uint64_t busy_fields_all; ///< liczba pól zajętych przez wszystkich graczy
 
     uint32_t areas; ///< maksymalna liczba obszarów, jakie można zająć, l.dodatnia
-    uint32_t *used_areas; ///< liczba obszarów, które zajmuje gracz
+    uint32_t limited_players; ///< liczba graczy, którzy zajmują @p areas obszarów
+
+    uint64_t stride; ///< długość wiersza planszy razem z ramką (width + 2)
+    uint64_t neighbour[GAMMA_NEIGHBOURS]; ///< przesunięcia indeksów sąsiadów
+                                          ///< pola: x-1, x+1, y-1, y+1
+    uint64_t ring[GAMMA_RING]; ///< przesunięcia indeksów pól pierścienia 3x3
+                               ///< wokół pola, kolejno dookoła od (x, y-1)
+    uint32_t *board; ///< board[i]=g – na polu o indeksie i stoi pionek gracza g;
+                     ///< plansza zapisana jest wierszami i otoczona ramką;
+                     ///< pola ramki obok zajętych pól mają wartość
+                     ///< @ref GAMMA_BORDER, a pozostałe – 0
+
+    uint64_t *parent; ///< struktura find and union: indeks rodzica pola
+                      ///< lub 0, jeśli pole jest reprezentantem
+    uint32_t *rank; ///< struktura find and union
+
+    uint8_t *tree_up; ///< las rozpinający obszarów: numer sąsiada, który
+                      ///< jest ojcem pola, plus jeden, lub 0 dla korzenia
+    uint64_t *block_h; ///< struktura find and union bloków (dwuspójnych
+                       ///< składowych) obszarów dla krawędzi do pola x+1:
+                       ///< ojciec krawędzi lub BLOCK_HEAD i najwyższe pole
+                       ///< bloku dla reprezentanta, 0 – krawędź bez bloku
+    uint64_t *block_v; ///< jak @p block_h dla krawędzi do pola y+1
+    uint64_t *block_mark; ///< znaczniki pól odwiedzonych przy łączeniu bloków
+    uint64_t block_stamp; ///< ostatnio użyty znacznik w @p block_mark
+
+    uint32_t *area_index; ///< area_index[i] – pozycja obszaru, którego
+                          ///< reprezentantem jest pole o indeksie i, w area_list
+    uint64_t touched_first; ///< najmniejszy indeks pola, które mogło zostać
+                            ///< zmienione w tablicach planszy
+    uint64_t touched_last; ///< największy indeks pola, które mogło zostać
+                           ///< zmienione; zakres jest pusty, gdy
+                           ///< touched_first > touched_last
+
+    gamma_bucket_t *standings; ///< kubełek graczy o największej liczbie pól
+    gamma_bucket_t *standings_last; ///< kubełek graczy o najmniejszej
+                                    ///< liczbie pól
+    gamma_bucket_t *free_buckets; ///< nieużywane kubełki (lista po @p next)
+    uint32_t free_buckets_count; ///< liczba nieużywanych kubełków
 
-    uint32_t **board; ///< board[x][y]=g – na polu (x,y) stoi pionek gracza g
-    bool *is_golden_used; ///< is_golden_used[g] – czy gracz g wykonał złoty ruch
+    uint64_t board_length; ///< suma długości opisów wszystkich pól planszy
 
-    pair_t **parent; ///< struktura find and union
-    uint32_t **rank; ///< struktura find and union
+    uint64_t version; ///< wersja gry – liczba zmian pól planszy
+    gamma_change_t *changes; ///< dziennik ostatnich zmian (bufor cykliczny)
+    uint64_t changes_size; ///< rozmiar dziennika zmian
 
+    gamma_rect_tree_t rect_trees[GAMMA_RECT_TREES]; ///< drzewa, z których
+                                                    ///< korzysta
+                                                    ///< @ref gamma_rect_count
+    uint32_t rect_tree_count; ///< liczba drzew w @p rect_trees
+    uint64_t rect_clock; ///< liczba zapytań, które użyły drzew
+    uint64_t rect_scanned; ///< liczba pól przejrzanych przez zapytania bez
+                           ///< drzewa od zbudowania ostatniego drzewa
 
-    uint64_t **low_visit_time; ///< czas odwiedzenia wierzchołka w trkacie LOW
-    uint64_t **low; ///< wartości funkcji LOW dla grafów poszczególnych obszarów
+    bool mobility_valid; ///< czy wyznaczono podsumowanie możliwości ruchu
+    uint64_t mobility_version; ///< wersja gry, której dotyczy podsumowanie
+    bool mobility_golden; ///< czy podsumowanie obejmuje @p golden_can
+    uint64_t golden_total; ///< liczba pól, które można przejąć złotym ruchem
+    uint32_t *mobile; ///< rosnąco numery graczy ze stanem, którzy mogą
+                      ///< wykonać ruch (rozmiar @p active_cap)
+    uint32_t mobile_count; ///< liczba graczy w @p mobile
+    bool inactive_mobile; ///< czy gracze bez stanu mogą wykonać ruch
+
+    gamma_stats_t stats; ///< liczniki operacji silnika
 };
 
 typedef struct gamma gamma_t;
@@ -56,7 +248,8 @@ typedef struct gamma gamma_t;
  * Inicjuje tę strukturę tak, aby reprezentowała początkowy stan gry.
  * @param[in] width   – szerokość planszy, liczba dodatnia,
  * @param[in] height  – wysokość planszy, liczba dodatnia,
- * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia niewiększa od
+ *                      @ref GAMMA_PLAYERS_MAX,
  * @param[in] areas   – maksymalna liczba obszarów,
  *                      jakie może zająć jeden gracz.
  * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
@@ -72,6 +265,37 @@ gamma_t *gamma_new(uint32_t width, uint32_t height,
  */
 void gamma_delete(gamma_t *g);
 
+/** @brief Przywraca grę do stanu początkowego.
+ * Ustawia liczbę graczy i obszarów tak jak @ref gamma_new, zachowując
+ * wymiary planszy i zaalokowaną pamięć, więc nie alokuje pamięci. Zeruje
+ * tylko te pola tablic planszy, które mogły zostać zmienione w tej grze.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] players – liczba graczy, liczba dodatnia niewiększa od
+ *                      @ref GAMMA_PLAYERS_MAX,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz.
+ * @return Wartość @p true, jeśli grę przywrócono, a @p false, gdy wskaźnik
+ * ma wartość NULL lub parametry są niepoprawne – gra się wtedy nie zmienia.
+ */
+bool gamma_reset(gamma_t *g, uint32_t players, uint32_t areas);
+
+/** @brief Kończy odtwarzanie gry z zapisu.
+ * Gra musi zostać utworzona z maksymalną liczbą obszarów równą UINT32_MAX,
+ * a zapisane pionki postawione zwykłymi ruchami (w dowolnej kolejności,
+ * bo limit obszarów ich wtedy nie ogranicza). Funkcja ustawia docelową
+ * maksymalną liczbę obszarów, oznacza graczy z @p golden jako tych, którzy
+ * wykonali już złoty ruch, i zeruje statystyki.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] areas   – maksymalna liczba obszarów, liczba dodatnia,
+ * @param[in] golden  – gracze, którzy wykonali złoty ruch,
+ * @param[in] count   – liczba graczy w @p golden.
+ * @return Wartość @p true, jeśli odtworzono grę, a @p false, gdy któryś
+ * z parametrów jest niepoprawny, któryś gracz zajmuje więcej niż @p areas
+ * obszarów lub nie udało się zaalokować pamięci.
+ */
+bool gamma_restore(gamma_t *g, uint32_t areas, const uint32_t *golden,
+                   uint32_t count);
+
 /** @brief Wykonuje ruch.
  * Ustawia pionek gracza @p player na polu (@p x, @p y).
  * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
@@ -133,6 +357,103 @@ uint64_t gamma_free_fields(gamma_t *g, uint32_t player);
  */
 bool gamma_golden_possible(gamma_t *g, uint32_t player);
 
+/** @brief Podaje gracza, którego pionek stoi na polu.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza.
+ * @return Numer gracza, 0 dla wolnego pola lub gdy któryś z parametrów
+ * jest niepoprawny.
+ */
+uint32_t gamma_owner(gamma_t *g, uint32_t x, uint32_t y);
+
+/** @brief Sprawdza, czy wynik gamma_golden_possible jest dostępny od razu.
+ * Wynik jest dostępny bez przeglądania planszy, jeśli gracz wykorzystał już
+ * złoty ruch, nie ma na planszy cudzych pól albo podsumowanie możliwości
+ * ruchu dla bieżącej wersji gry obejmuje złote ruchy.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza.
+ * @return Wartość @p true, jeśli wynik jest dostępny od razu,
+ * a @p false w przeciwnym razie.
+ */
+bool gamma_golden_known(gamma_t *g, uint32_t player);
+
+/** @brief Sprawdza, czy gracz może wykonać złoty ruch, z możliwością przerwania.
+ * Działa jak @ref gamma_golden_possible, ale przed sprawdzeniem każdego pola
+ * odczytuje flagę @p cancel i przerywa obliczenia, jeśli jest ustawiona.
+ * Flagę może ustawiać inny wątek.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[in] cancel  – flaga przerwania obliczeń lub NULL,
+ * @param[out] result – wynik @ref gamma_golden_possible.
+ * @return Wartość @p true, jeśli wynik został wyznaczony, a @p false, gdy
+ * obliczenia przerwano lub @p result ma wartość NULL.
+ */
+bool gamma_golden_possible_cancellable(gamma_t *g, uint32_t player,
+                                       atomic_bool *cancel, bool *result);
+
+/** @brief Podaje obszary gracza.
+ * Zapisuje do @p out (najwyżej @p cap) obszarów gracza w nieokreślonej
+ * kolejności: reprezentanta obszaru i liczbę jego pól. Rejestr obszarów
+ * jest aktualizowany przy każdym ruchu, więc wywołanie nie przegląda planszy.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[out] out    – tablica na obszary,
+ * @param[in] cap     – rozmiar tablicy @p out.
+ * @return Liczba obszarów gracza lub 0, gdy któryś z parametrów
+ * jest niepoprawny.
+ */
+uint64_t gamma_areas(gamma_t *g, uint32_t player, gamma_area_t *out,
+                     uint64_t cap);
+
+/** @brief Sprawdza, czy gra się zakończyła.
+ * Gra kończy się, gdy żaden gracz nie może wykonać ruchu ani złotego ruchu.
+ * Dopóki jest wolne pole i któryś gracz nie zajmuje maksymalnej liczby
+ * obszarów, odpowiedź udzielana jest w czasie stałym; w przeciwnym razie
+ * korzysta z podsumowania możliwości ruchu (@ref gamma_next_player).
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli gra się zakończyła, a @p false w przeciwnym
+ * razie lub gdy parametr jest niepoprawny.
+ */
+bool gamma_game_over(gamma_t *g);
+
+/** @brief Podaje klasyfikację graczy.
+ * Zapisuje do @p out (najwyżej @p k) graczy zajmujących przynajmniej jedno
+ * pole, w kolejności malejącej liczby zajętych pól. Kolejność graczy
+ * o tej samej liczbie pól jest nieokreślona. Klasyfikacja jest aktualizowana
+ * przy każdym ruchu, więc wywołanie działa w czasie O(k).
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] out    – tablica na pozycje graczy,
+ * @param[in] k       – rozmiar tablicy @p out.
+ * @return Liczba zapisanych pozycji.
+ */
+uint32_t gamma_standings(gamma_t *g, gamma_standing_t *out, uint32_t k);
+
+/** @brief Podaje graczy, którzy wykonali już złoty ruch.
+ * Zapisuje do @p out najwyżej @p k takich graczy w nieokreślonej kolejności.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] out    – tablica na numery graczy lub NULL, gdy @p k = 0,
+ * @param[in] k       – rozmiar tablicy @p out.
+ * @return Liczba wszystkich takich graczy, także gdy jest większa od @p k.
+ */
+uint32_t gamma_golden_players(gamma_t *g, uint32_t *out, uint32_t k);
+
+/** @brief Podaje gracza, który wykonuje ruch po danym graczu.
+ * Szuka, w kolejności rozgrywki, pierwszego gracza po graczu @p player
+ * (być może samego @p player), dla którego @ref gamma_free_fields zwraca
+ * liczbę dodatnią lub @ref gamma_golden_possible zwraca @p true.
+ * Podsumowanie możliwości ruchu wszystkich graczy wyznaczane jest raz
+ * dla każdej wersji gry, kolejne wywołania w tej samej wersji działają
+ * w czasie stałym.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new.
+ * @return Numer gracza lub 0, jeśli żaden gracz nie może wykonać ruchu
+ * lub któryś z parametrów jest niepoprawny.
+ */
+uint32_t gamma_next_player(gamma_t *g, uint32_t player);
+
 /** @brief Daje napis opisujący stan planszy.
  * Alokuje w pamięci bufor, w którym umieszcza napis zawierający tekstowy
  * opis aktualnego stanu planszy. Przykład znajduje się w pliku gamma_test.c.
@@ -143,6 +464,219 @@ bool gamma_golden_possible(gamma_t *g, uint32_t player);
  */
 char *gamma_board(gamma_t *g);
 
+/** @brief Zapisuje napis opisujący stan planszy do bufora wywołującego.
+ * Napis jest taki sam jak zwracany przez @ref gamma_board. Jeśli bufor jest
+ * za mały, żeby pomieścić napis wraz z kończącym go znakiem '\0',
+ * nic nie jest zapisywane. Długość napisu liczona jest w czasie stałym,
+ * więc wywołanie z @p buf równym NULL pozwala dobrać rozmiar bufora.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] buf    – bufor na napis lub NULL,
+ * @param[in] cap     – rozmiar bufora.
+ * @return Długość napisu (bez kończącego go znaku '\0') lub zero,
+ * jeśli @p g ma wartość NULL.
+ */
+uint64_t gamma_board_into(gamma_t *g, char *buf, uint64_t cap);
+
+/** @brief Wypisuje napis opisujący stan planszy do strumienia.
+ * Napis jest taki sam jak zwracany przez @ref gamma_board, ale jest
+ * wypisywany fragmentami o stałym rozmiarze, więc pamięć potrzebna
+ * do jego wypisania nie zależy od rozmiaru planszy.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] out     – strumień, do którego wypisywany jest napis.
+ * @return Wartość @p true, jeśli napis został wypisany, a @p false,
+ * gdy któryś z parametrów jest niepoprawny lub zapis się nie powiódł.
+ */
+bool gamma_board_write(gamma_t *g, FILE *out);
+
+/** @brief Wypisuje stan planszy do strumienia jako serie pól.
+ * Wypisuje linię "R <szerokość> <wysokość>", a po niej jedną linię serii
+ * pól oddzielonych spacjami. Pola przeglądane są w tej samej kolejności,
+ * co w @ref gamma_board (wierszami od y = height - 1, a w wierszu od x = 0),
+ * a seria może przechodzić do kolejnego wiersza. Seria jednego pola to numer
+ * gracza lub 0 dla wolnego pola, a dłuższa seria to "<gracz>*<długość>".
+ * Napis jest wypisywany w jednym przejściu po planszy, fragmentami o stałym
+ * rozmiarze.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] out     – strumień, do którego wypisywany jest napis.
+ * @return Wartość @p true, jeśli napis został wypisany, a @p false,
+ * gdy któryś z parametrów jest niepoprawny lub zapis się nie powiódł.
+ */
+bool gamma_board_rle_write(gamma_t *g, FILE *out);
+
+/** @brief Podaje wersję gry.
+ * Wersja zwiększa się o jeden przy każdym wykonanym ruchu i złotym ruchu.
+ * Nowa gra ma wersję zero.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wersja gry lub zero, jeśli @p g ma wartość NULL.
+ */
+uint64_t gamma_version(gamma_t *g);
+
+/** @brief Podaje pola zmienione od podanej wersji gry.
+ * Zapisuje do @p out (najwyżej @p cap) zmian od najstarszej do najnowszej.
+ * Pole zmienione kilka razy występuje kilka razy – stan pola wyznacza jego
+ * ostatnia zmiana. Dziennik zmian ma ograniczony rozmiar; jeśli nie obejmuje
+ * już wersji @p since_version, należy pobrać całą planszę za pomocą
+ * @ref gamma_board.
+ * @param[in] g             – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] since_version – wersja gry znana wywołującemu,
+ * @param[out] out          – tablica na zmiany,
+ * @param[in] cap           – rozmiar tablicy @p out,
+ * @param[out] count        – liczba zmian od wersji @p since_version.
+ * @return Wartość @p true, jeśli zmiany zostały podane, a @p false, gdy
+ * dziennik nie obejmuje wersji @p since_version lub któryś z parametrów
+ * jest niepoprawny.
+ */
+bool gamma_board_diff(gamma_t *g, uint64_t since_version,
+                      gamma_change_t *out, uint64_t cap, uint64_t *count);
+
+/** @brief Liczy pola gracza w prostokącie planszy.
+ * Prostokąt obejmuje pola (x, y), dla których x0 <= x <= x1 oraz
+ * y0 <= y <= y1. Małe prostokąty liczone są bezpośrednio na planszy.
+ * Dla większych budowane jest dwuwymiarowe drzewo Fenwicka sum pól gracza
+ * w blokach @ref GAMMA_RECT_BLOCK × @ref GAMMA_RECT_BLOCK, ale dopiero gdy
+ * zapytania bez drzewa przejrzały tyle pól, ile ma plansza (tyle kosztuje
+ * zbudowanie drzewa). Drzewo liczy pełne bloki prostokąta w czasie
+ * O(log(width) * log(height)), a pola przy jego brzegach liczone są
+ * bezpośrednio; ruchy i złote ruchy aktualizują je w takim samym czasie.
+ * Drzew jest najwyżej @ref GAMMA_RECT_TREES i zajmują razem nie więcej
+ * pamięci niż tablica pól planszy; drzewo gracza, o którego dawno nie
+ * pytano, jest zastępowane, a gdy drzewo się nie mieści, prostokąt liczony
+ * jest bezpośrednio.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza lub 0 dla wolnych pól,
+ * @param[in] x0      – numer pierwszej kolumny prostokąta,
+ * @param[in] y0      – numer pierwszego wiersza prostokąta,
+ * @param[in] x1      – numer ostatniej kolumny prostokąta,
+ * @param[in] y1      – numer ostatniego wiersza prostokąta.
+ * @return Liczba pól gracza (lub wolnych pól) w prostokącie lub zero,
+ * jeśli któryś z parametrów jest niepoprawny.
+ */
+uint64_t gamma_rect_count(gamma_t *g, uint32_t player, uint32_t x0,
+                          uint32_t y0, uint32_t x1, uint32_t y1);
+
+/** @brief Podaje liczniki operacji silnika gry.
+ * Kopiuje do @p out liczniki zebrane od utworzenia gry.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] out    – wskaźnik na strukturę, do której kopiowane są liczniki.
+ * @return Wartość @p true, jeśli liczniki zostały skopiowane, a @p false,
+ * gdy któryś z parametrów jest niepoprawny lub silnik skompilowano
+ * bez makra GAMMA_STATS.
+ */
+bool gamma_stats(gamma_t *g, gamma_stats_t *out);
+
+/** @brief Parametry nowej gry.
+ */
+struct gamma_params {
+    uint32_t width; ///< szerokość planszy, liczba dodatnia
+    uint32_t height; ///< wysokość planszy, liczba dodatnia
+    uint32_t players; ///< liczba graczy, liczba dodatnia
+    uint32_t areas; ///< maksymalna liczba obszarów jednego gracza
+};
+typedef struct gamma_params gamma_params_t;
+
+/** @brief Silnik gry – tablica operacji na stanie gry.
+ * Operacje mają takie same parametry i wyniki jak odpowiadające im funkcje
+ * gamma_*, ale zamiast wskaźnika na gamma_t dostają stan utworzony przez
+ * @p create danego silnika.
+ */
+struct gamma_backend {
+    const char *name; ///< nazwa silnika (opcja --backend)
+    bool automatic; ///< czy silnik może zostać wybrany automatycznie
+    uint64_t max_cells; ///< największa liczba pól planszy lub 0 – bez limitu
+    uint32_t max_players; ///< największa liczba graczy lub 0 – bez limitu
+    void *(*create)(const gamma_params_t *params); ///< jak @ref gamma_new
+    void (*destroy)(void *game); ///< jak @ref gamma_delete
+    bool (*move)(void *game, uint32_t player,
+                 uint32_t x, uint32_t y); ///< jak @ref gamma_move
+    bool (*golden_move)(void *game, uint32_t player,
+                        uint32_t x, uint32_t y); ///< jak @ref gamma_golden_move
+    uint64_t (*busy_fields)(void *game,
+                            uint32_t player); ///< jak @ref gamma_busy_fields
+    uint64_t (*free_fields)(void *game,
+                            uint32_t player); ///< jak @ref gamma_free_fields
+    bool (*golden_possible)(void *game,
+                            uint32_t player); ///< jak @ref gamma_golden_possible
+    char *(*board)(void *game); ///< jak @ref gamma_board
+    bool (*board_write)(void *game, FILE *out); ///< jak @ref gamma_board_write
+};
+typedef struct gamma_backend gamma_backend_t;
+
+/** @brief Gra prowadzona przez wybrany silnik.
+ */
+struct gamma_engine {
+    const gamma_backend_t *backend; ///< silnik gry
+    void *game; ///< stan gry utworzony przez silnik
+    gamma_params_t params; ///< parametry gry
+};
+typedef struct gamma_engine gamma_engine_t;
+
+/** @brief Podaje silnik o danym numerze.
+ * Silniki numerowane są od zera w kolejności, w jakiej są preferowane przy
+ * wyborze automatycznym. Silnik numer zero to gamma_t z tego pliku.
+ * @param[in] index   – numer silnika.
+ * @return Wskaźnik na silnik lub NULL, jeśli nie ma silnika o tym numerze.
+ */
+const gamma_backend_t *gamma_backend_at(uint32_t index);
+
+/** @brief Znajduje silnik o danej nazwie.
+ * @param[in] name    – nazwa silnika.
+ * @return Wskaźnik na silnik lub NULL, jeśli nie ma silnika o tej nazwie.
+ */
+const gamma_backend_t *gamma_backend_find(const char *name);
+
+/** @brief Sprawdza, czy silnik obsługuje grę o danych parametrach.
+ * @param[in] backend – silnik,
+ * @param[in] params  – parametry gry.
+ * @return Wartość @p true, jeśli liczba pól planszy i liczba graczy mieszczą
+ * się w limitach silnika, a @p false w przeciwnym razie.
+ */
+bool gamma_backend_fits(const gamma_backend_t *backend,
+                        const gamma_params_t *params);
+
+/** @brief Wybiera silnik dla gry o danych parametrach.
+ * Wybiera pierwszy silnik, który może zostać wybrany automatycznie
+ * i obsługuje grę o liczbie pól @p width * @p height i liczbie graczy
+ * @p players.
+ * @param[in] params  – parametry gry.
+ * @return Wskaźnik na silnik.
+ */
+const gamma_backend_t *gamma_backend_pick(const gamma_params_t *params);
+
+/** @brief Tworzy grę prowadzoną przez silnik @p backend.
+ * @param[in] params  – parametry gry, jak w @ref gamma_new,
+ * @param[in] backend – silnik lub NULL, jeśli ma zostać wybrany
+ *                      funkcją @ref gamma_backend_pick.
+ * @return Wskaźnik na grę lub NULL, gdy nie udało się zaalokować pamięci,
+ * któryś z parametrów jest niepoprawny lub silnik nie obsługuje gry
+ * o takich parametrach.
+ */
+gamma_engine_t *gamma_new_ex(const gamma_params_t *params,
+                             const gamma_backend_t *backend);
+
+/** @brief Usuwa grę utworzoną funkcją @ref gamma_new_ex.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] e       – wskaźnik na grę.
+ */
+void gamma_engine_delete(gamma_engine_t *e);
+
+/** @brief Tworzy grę prowadzoną przez silnik gamma_t z istniejącego stanu gry.
+ * W przypadku powodzenia stan @p g należy od tej chwili do utworzonej gry
+ * i jest usuwany przez @ref gamma_engine_delete.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Gra lub NULL, gdy @p g ma wartość NULL lub nie udało się
+ * zaalokować pamięci.
+ */
+gamma_engine_t *gamma_engine_from_dense(gamma_t *g);
+
+/** @brief Podaje stan gry prowadzonej przez silnik gamma_t.
+ * Pozwala użyć funkcji z tego pliku, których nie ma w tablicy operacji
+ * silnika, np. @ref gamma_board_diff i @ref gamma_stats.
+ * @param[in] e       – wskaźnik na grę lub NULL.
+ * @return Wskaźnik na strukturę przechowującą stan gry lub NULL, jeśli grę
+ * prowadzi inny silnik.
+ */
+gamma_t *gamma_engine_dense(gamma_engine_t *e);
+
 /** @brief Dodaje znak @p l na koniec bufora @p board.
  * Sprawdza, czy bufor nie uległ przepełnieniu.
  * Jeśli tak, to zwiększa jego rozmiar dwukrotnie
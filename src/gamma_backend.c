@@ -0,0 +1,155 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "gamma.h"
+#include "gamma_reference.h"
+#include <string.h>
+
+/* @brief Tworzy grę silnika gamma_t.
+ * @param[in] params  – parametry gry.
+ * @return Wynik @ref gamma_new.
+ */
+static void *dense_create(const gamma_params_t *params) {
+    return gamma_new(params->width, params->height, params->players,
+                     params->areas);
+}
+
+/* @brief Usuwa grę silnika gamma_t.
+ * @param[in] game    – stan gry.
+ */
+static void dense_destroy(void *game) {
+    gamma_delete(game);
+}
+
+/* @brief Wywołuje @ref gamma_move. */
+static bool dense_move(void *game, uint32_t player, uint32_t x, uint32_t y) {
+    return gamma_move(game, player, x, y);
+}
+
+/* @brief Wywołuje @ref gamma_golden_move. */
+static bool dense_golden_move(void *game, uint32_t player,
+                              uint32_t x, uint32_t y) {
+    return gamma_golden_move(game, player, x, y);
+}
+
+/* @brief Wywołuje @ref gamma_busy_fields. */
+static uint64_t dense_busy_fields(void *game, uint32_t player) {
+    return gamma_busy_fields(game, player);
+}
+
+/* @brief Wywołuje @ref gamma_free_fields. */
+static uint64_t dense_free_fields(void *game, uint32_t player) {
+    return gamma_free_fields(game, player);
+}
+
+/* @brief Wywołuje @ref gamma_golden_possible. */
+static bool dense_golden_possible(void *game, uint32_t player) {
+    return gamma_golden_possible(game, player);
+}
+
+/* @brief Wywołuje @ref gamma_board. */
+static char *dense_board(void *game) {
+    return gamma_board(game);
+}
+
+/* @brief Wywołuje @ref gamma_board_write. */
+static bool dense_board_write(void *game, FILE *out) {
+    return gamma_board_write(game, out);
+}
+
+/** Silnik gamma_t – plansza w jednej tablicy z ramką.
+ */
+static const gamma_backend_t dense_backend = {
+    .name = "dense",
+    .automatic = true,
+    .max_cells = 0,
+    .max_players = 0,
+    .create = dense_create,
+    .destroy = dense_destroy,
+    .move = dense_move,
+    .golden_move = dense_golden_move,
+    .busy_fields = dense_busy_fields,
+    .free_fields = dense_free_fields,
+    .golden_possible = dense_golden_possible,
+    .board = dense_board,
+    .board_write = dense_board_write,
+};
+
+/** Silniki w kolejności, w jakiej są preferowane przy wyborze automatycznym.
+ */
+static const gamma_backend_t *const backends[] = {
+    &dense_backend,
+    &gamma_reference_backend,
+};
+
+const gamma_backend_t *gamma_backend_at(uint32_t index) {
+    if (index >= sizeof(backends) / sizeof(backends[0])) return NULL;
+    return backends[index];
+}
+
+const gamma_backend_t *gamma_backend_find(const char *name) {
+    const gamma_backend_t *backend;
+    for (uint32_t i = 0; (backend = gamma_backend_at(i)) != NULL; i++)
+        if (strcmp(backend->name, name) == 0) return backend;
+    return NULL;
+}
+
+bool gamma_backend_fits(const gamma_backend_t *backend,
+                        const gamma_params_t *params) {
+    uint64_t cells = (uint64_t) params->width * params->height;
+    return (backend->max_cells == 0 || cells <= backend->max_cells)
+           && (backend->max_players == 0
+               || params->players <= backend->max_players);
+}
+
+const gamma_backend_t *gamma_backend_pick(const gamma_params_t *params) {
+    const gamma_backend_t *backend;
+    for (uint32_t i = 0; (backend = gamma_backend_at(i)) != NULL; i++)
+        if (backend->automatic && gamma_backend_fits(backend, params))
+            return backend;
+    //silnik gamma_t nie ma limitów
+    return &dense_backend;
+}
+
+gamma_engine_t *gamma_new_ex(const gamma_params_t *params,
+                             const gamma_backend_t *backend) {
+    if (params == NULL) return NULL;
+    if (backend == NULL) backend = gamma_backend_pick(params);
+    if (!gamma_backend_fits(backend, params)) return NULL;
+
+    gamma_engine_t *e = malloc(sizeof(gamma_engine_t));
+    if (e == NULL) return NULL;
+    e->backend = backend;
+    e->params = *params;
+    e->game = backend->create(params);
+    if (e->game == NULL) {
+        free(e);
+        return NULL;
+    }
+    return e;
+}
+
+gamma_engine_t *gamma_engine_from_dense(gamma_t *g) {
+    if (g == NULL) return NULL;
+    gamma_engine_t *e = malloc(sizeof(gamma_engine_t));
+    if (e == NULL) return NULL;
+    e->backend = &dense_backend;
+    e->params = (gamma_params_t) {g->width, g->height, g->players, g->areas};
+    e->game = g;
+    return e;
+}
+
+void gamma_engine_delete(gamma_engine_t *e) {
+    if (e == NULL) return;
+    e->backend->destroy(e->game);
+    free(e);
+}
+
+gamma_t *gamma_engine_dense(gamma_engine_t *e) {
+    if (e == NULL || e->backend != &dense_backend) return NULL;
+    return e->game;
+}
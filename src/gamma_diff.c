@@ -0,0 +1,222 @@
+/* @file
+ * Porównanie silników gry gamma na jednym skrypcie trybu wsadowego
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "gamma.h"
+#include "latency.h"
+#include "parse.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Polecenie skryptu.
+ */
+typedef struct diff_command {
+    char kind; ///< litera polecenia: m, g, b, f, q lub p
+    uint32_t argv[3]; ///< argumenty polecenia
+    uint64_t line; ///< numer linii skryptu
+} diff_command_t;
+
+/** @brief Wczytany skrypt.
+ */
+typedef struct diff_script {
+    gamma_params_t params; ///< parametry gry z linii B
+    diff_command_t *commands; ///< polecenia po linii B
+    uint64_t count; ///< liczba poleceń
+    uint64_t cap; ///< rozmiar tablicy @p commands
+} diff_script_t;
+
+/* @brief Podaje liczbę argumentów polecenia.
+ * @param[in] kind    – litera polecenia.
+ * @return Liczba argumentów lub -1, jeśli polecenie nie jest porównywane.
+ */
+static int command_argc(char kind) {
+    switch (kind) {
+        case 'm': case 'g': return 3;
+        case 'b': case 'f': case 'q': return 1;
+        case 'p': return 0;
+        default: return -1;
+    }
+}
+
+/* @brief Dopisuje polecenie do skryptu.
+ * @param[in,out] script – skrypt,
+ * @param[in] kind       – litera polecenia,
+ * @param[in] argv       – argumenty polecenia,
+ * @param[in] line       – numer linii skryptu.
+ * @return Wartość @p true, jeśli dopisano polecenie, a @p false, gdy nie
+ * udało się zaalokować pamięci.
+ */
+static bool script_push(diff_script_t *script, char kind,
+                        const uint32_t *argv, uint64_t line) {
+    if (script->count == script->cap) {
+        uint64_t cap = script->cap == 0 ? 1024 : 2 * script->cap;
+        diff_command_t *commands = realloc(script->commands,
+                                           cap * sizeof(diff_command_t));
+        if (commands == NULL) return false;
+        script->commands = commands;
+        script->cap = cap;
+    }
+    diff_command_t *c = &script->commands[script->count++];
+    c->kind = kind;
+    memcpy(c->argv, argv, sizeof(c->argv));
+    c->line = line;
+    return true;
+}
+
+/* @brief Wczytuje skrypt. Linie dzieli i wczytuje tak jak tryb wsadowy
+ * (@ref parse_arguments), a linia bez znaku końca linii nie jest
+ * poleceniem. Pomija linie poprzedzające pierwszą poprawną linię B oraz
+ * linie, których nie da się porównać.
+ * @param[in] path    – ścieżka do skryptu,
+ * @param[out] script – skrypt.
+ * @return Wartość @p true, jeśli wczytano linię B,
+ * a @p false w przeciwnym razie.
+ */
+static bool read_script(const char *path, diff_script_t *script) {
+    FILE *in = fopen(path, "r");
+    if (in == NULL) return false;
+    memset(script, 0, sizeof(diff_script_t));
+    uint64_t size = 1, index = 0;
+    char *text = calloc(size, sizeof(char));
+    uint32_t argv[COMMAND_ARGS_MAX];
+    bool started = false, valid = text != NULL;
+    int letter;
+    for (uint64_t line = 1; valid && (letter = getc(in)) != EOF;) {
+        if (letter != '\n') {
+            valid = add_letter(&index, &size, &text, (char) letter);
+            continue;
+        }
+        int32_t argc = index == 0 || text[0] == '#'
+                       ? -1 : parse_arguments(text, index, argv);
+        if (!started) {
+            started = text[0] == 'B' && argc == 4;
+            if (started)
+                script->params = (gamma_params_t) {argv[0], argv[1], argv[2],
+                                                   argv[3]};
+        } else if (argc >= 0 && argc == command_argc(text[0])) {
+            valid = script_push(script, text[0], argv, line);
+        }
+        line++;
+        index = 0;
+    }
+    free(text);
+    fclose(in);
+    return started;
+}
+
+/* @brief Liczy skrót FNV-1a napisu.
+ * @param[in] text    – napis lub NULL.
+ * @return Skrót napisu.
+ */
+static uint64_t hash(const char *text) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (; text != NULL && *text != '\0'; text++)
+        h = (h ^ (unsigned char) *text) * 0x100000001b3ULL;
+    return h;
+}
+
+/* @brief Wykonuje polecenie skryptu.
+ * @param[in,out] e   – gra,
+ * @param[in] c       – polecenie.
+ * @return Wynik polecenia; dla polecenia p skrót planszy.
+ */
+static uint64_t run_command(gamma_engine_t *e, const diff_command_t *c) {
+    const gamma_backend_t *b = e->backend;
+    switch (c->kind) {
+        case 'm': return b->move(e->game, c->argv[0], c->argv[1], c->argv[2]);
+        case 'g': return b->golden_move(e->game, c->argv[0], c->argv[1],
+                                        c->argv[2]);
+        case 'b': return b->busy_fields(e->game, c->argv[0]);
+        case 'f': return b->free_fields(e->game, c->argv[0]);
+        case 'q': return b->golden_possible(e->game, c->argv[0]);
+        default: {
+            char *board = b->board(e->game);
+            uint64_t h = hash(board);
+            free(board);
+            return h;
+        }
+    }
+}
+
+/* @brief Wykonuje skrypt na silniku.
+ * @param[in] backend – silnik,
+ * @param[in] script  – skrypt,
+ * @param[out] result – wyniki kolejnych poleceń,
+ * @param[out] time   – łączny czas wykonania (w nanosekundach).
+ * @return Wartość @p true, jeśli udało się utworzyć grę,
+ * a @p false w przeciwnym razie.
+ */
+static bool run_script(const gamma_backend_t *backend,
+                       const diff_script_t *script, uint64_t *result,
+                       uint64_t *time) {
+    uint64_t start = latency_now();
+    gamma_engine_t *e = gamma_new_ex(&script->params, backend);
+    if (e == NULL) return false;
+    for (uint64_t i = 0; i < script->count; i++)
+        result[i] = run_command(e, &script->commands[i]);
+    gamma_engine_delete(e);
+    *time = latency_now() - start;
+    return true;
+}
+
+/* @brief Funkcja main programu gamma_diff.
+ * Wykonuje skrypt trybu wsadowego na każdym silniku, który obsługuje
+ * parametry gry z linii B, i porównuje wyniki z pierwszym z nich.
+ * Dla każdego silnika wypisuje jego nazwę i czas wykonania,
+ * a dla każdej niezgodności nazwę silnika i numer linii skryptu.
+ * @return @p 0, jeśli wszystkie silniki dały te same wyniki,
+ * a @p 1 w przeciwnym razie.
+ */
+int main(int argc, char *argv[]) {
+    diff_script_t script;
+    if (argc != 2) {
+        fprintf(stderr, "Użycie: %s SKRYPT\n", argv[0]);
+        return 1;
+    }
+    if (!read_script(argv[1], &script)) {
+        fprintf(stderr, "ERROR %s\n", argv[1]);
+        return 1;
+    }
+
+    uint64_t *expected = malloc((script.count + 1) * sizeof(uint64_t));
+    uint64_t *result = malloc((script.count + 1) * sizeof(uint64_t));
+    const gamma_backend_t *backend;
+    uint64_t mismatches = 0, runs = 0;
+    bool created = false;
+    for (uint32_t i = 0; expected != NULL && result != NULL
+                         && (backend = gamma_backend_at(i)) != NULL; i++) {
+        uint64_t time;
+        if (!gamma_backend_fits(backend, &script.params)) continue;
+        //gra, której nie da się utworzyć, nie może zostać utworzona nigdzie
+        bool ok = run_script(backend, &script, runs == 0 ? expected : result,
+                             &time);
+        if (runs++ == 0) created = ok;
+        if (ok != created) {
+            printf("MISMATCH %s B\n", backend->name);
+            mismatches++;
+        }
+        if (!ok) {
+            printf("%s ERROR\n", backend->name);
+            continue;
+        }
+        printf("%s %lu\n", backend->name, time);
+        if (runs == 1 || !created) continue;
+        for (uint64_t j = 0; j < script.count; j++) {
+            if (result[j] != expected[j]) {
+                printf("MISMATCH %s line %lu\n", backend->name,
+                       script.commands[j].line);
+                mismatches++;
+            }
+        }
+    }
+    bool failed = expected == NULL || result == NULL || mismatches > 0;
+    free(expected);
+    free(result);
+    free(script.commands);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,340 @@
+/* @file
+ * Generator skryptów dla trybu wsadowego gry gamma
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** Rozmiar bufora wyjściowego.
+ */
+#define OUT_SIZE (1 << 16)
+
+/** Liczba rodzajów poleceń, których częstość można ustawić (m, b, f, q, p).
+ */
+#define KINDS 5
+
+/** Litery poleceń w kolejności odpowiadającej wagom w @ref gen_t.
+ */
+static const char kind_letter[KINDS] = {'m', 'b', 'f', 'q', 'p'};
+
+/** @brief Parametry i stan generatora.
+ */
+typedef struct gen {
+    uint64_t seed; ///< stan generatora liczb pseudolosowych
+    uint32_t width; ///< szerokość planszy
+    uint32_t height; ///< wysokość planszy
+    uint32_t players; ///< liczba graczy
+    uint32_t areas; ///< maksymalna liczba obszarów
+    uint64_t lines; ///< liczba generowanych poleceń (bez linii B)
+    uint32_t weight[KINDS]; ///< wagi poleceń m, b, f, q, p
+    double golden; ///< część ruchów, które są złotymi ruchami
+    double invalid; ///< część linii, które są niepoprawne
+
+    char out[OUT_SIZE]; ///< bufor wyjściowy
+    size_t out_len; ///< zapełniona część bufora
+} gen_t;
+
+/* @brief Zwraca kolejną liczbę pseudolosową (splitmix64).
+ * @param[in,out] gen – stan generatora.
+ * @return Liczba pseudolosowa.
+ */
+static uint64_t next_random(gen_t *gen) {
+    uint64_t z = (gen->seed += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* @brief Losuje liczbę z przedziału [0, @p n).
+ * @param[in,out] gen – stan generatora,
+ * @param[in] n       – górne ograniczenie, liczba dodatnia.
+ * @return Liczba pseudolosowa mniejsza od @p n.
+ */
+static uint64_t random_below(gen_t *gen, uint64_t n) {
+    return next_random(gen) % n;
+}
+
+/* @brief Losuje wartość logiczną, która jest prawdziwa z prawdopodobieństwem @p p.
+ * @param[in,out] gen – stan generatora,
+ * @param[in] p       – prawdopodobieństwo.
+ * @return Wylosowana wartość.
+ */
+static bool random_chance(gen_t *gen, double p) {
+    return (next_random(gen) >> 11) * (1.0 / 9007199254740992.0) < p;
+}
+
+/* @brief Wypisuje zawartość bufora na standardowe wyjście.
+ * @param[in,out] gen – stan generatora.
+ */
+static void flush_out(gen_t *gen) {
+    if (gen->out_len > 0
+        && fwrite(gen->out, 1, gen->out_len, stdout) != gen->out_len) {
+        exit(1);
+    }
+    gen->out_len = 0;
+}
+
+/* @brief Dopisuje napis do bufora wyjściowego.
+ * @param[in,out] gen – stan generatora,
+ * @param[in] s       – dopisywany napis,
+ * @param[in] len     – długość napisu.
+ */
+static void put_string(gen_t *gen, const char *s, size_t len) {
+    if (gen->out_len + len > OUT_SIZE) flush_out(gen);
+    memcpy(gen->out + gen->out_len, s, len);
+    gen->out_len += len;
+}
+
+/* @brief Dopisuje znak do bufora wyjściowego.
+ * @param[in,out] gen – stan generatora,
+ * @param[in] c       – dopisywany znak.
+ */
+static void put_char(gen_t *gen, char c) {
+    if (gen->out_len == OUT_SIZE) flush_out(gen);
+    gen->out[gen->out_len++] = c;
+}
+
+/* @brief Dopisuje liczbę w zapisie dziesiętnym do bufora wyjściowego.
+ * @param[in,out] gen – stan generatora,
+ * @param[in] n       – dopisywana liczba.
+ */
+static void put_number(gen_t *gen, uint64_t n) {
+    char digits[20];
+    size_t len = 0;
+    do {
+        digits[sizeof(digits) - 1 - len++] = (char) ('0' + n % 10);
+        n /= 10;
+    } while (n > 0);
+    put_string(gen, digits + sizeof(digits) - len, len);
+}
+
+/* @brief Losuje numer gracza.
+ * @param[in,out] gen – stan generatora.
+ * @return Numer gracza z przedziału [1, players].
+ */
+static uint32_t random_player(gen_t *gen) {
+    return 1 + (uint32_t) random_below(gen, gen->players);
+}
+
+/* @brief Wypisuje poprawne polecenie wybranego rodzaju.
+ * @param[in,out] gen – stan generatora,
+ * @param[in] kind    – indeks polecenia w tablicy @ref kind_letter.
+ */
+static void put_valid(gen_t *gen, int kind) {
+    char letter = kind_letter[kind];
+    if (letter == 'm' && random_chance(gen, gen->golden)) letter = 'g';
+    put_char(gen, letter);
+    if (letter == 'm' || letter == 'g') {
+        put_char(gen, ' ');
+        put_number(gen, random_player(gen));
+        put_char(gen, ' ');
+        put_number(gen, random_below(gen, gen->width));
+        put_char(gen, ' ');
+        put_number(gen, random_below(gen, gen->height));
+    } else if (letter != 'p') {
+        put_char(gen, ' ');
+        put_number(gen, random_player(gen));
+    }
+    put_char(gen, '\n');
+}
+
+/* @brief Wypisuje niepoprawną linię.
+ * Każdy z rodzajów błędów odpowiada innej ścieżce kończącej się wypisaniem
+ * "ERROR <line>": nieznane polecenie, brak spacji po literze polecenia,
+ * zbyt mało lub zbyt dużo argumentów, argument spoza zakresu uint32_t,
+ * niedozwolony znak oraz biały znak przed literą polecenia.
+ * @param[in,out] gen – stan generatora.
+ */
+static void put_invalid(gen_t *gen) {
+    switch (random_below(gen, 7)) {
+        case 0:
+            put_string(gen, "x 1 1 1\n", 8);
+            break;
+        case 1:
+            put_char(gen, 'm');
+            put_number(gen, random_player(gen));
+            put_string(gen, " 0 0\n", 5);
+            break;
+        case 2:
+            put_string(gen, "g ", 2);
+            put_number(gen, random_player(gen));
+            put_string(gen, " 0\n", 3);
+            break;
+        case 3:
+            put_string(gen, "b ", 2);
+            put_number(gen, random_player(gen));
+            put_string(gen, " 1\n", 3);
+            break;
+        case 4:
+            put_string(gen, "f 4294967296\n", 13);
+            break;
+        case 5:
+            put_string(gen, "q -1\n", 5);
+            break;
+        default:
+            put_string(gen, " p\n", 3);
+            break;
+    }
+}
+
+/* @brief Losuje rodzaj polecenia zgodnie z wagami.
+ * @param[in,out] gen – stan generatora,
+ * @param[in] total   – suma wag, liczba dodatnia.
+ * @return Indeks polecenia w tablicy @ref kind_letter.
+ */
+static int random_kind(gen_t *gen, uint64_t total) {
+    uint64_t r = random_below(gen, total);
+    int kind = 0;
+    while (r >= gen->weight[kind]) {
+        r -= gen->weight[kind];
+        kind++;
+    }
+    return kind;
+}
+
+/* @brief Wczytuje wagi poleceń w postaci "m:60,b:10,f:10,q:19,p:1".
+ * Polecenia pominięte w napisie mają wagę zero.
+ * @param[out] gen – stan generatora,
+ * @param[in] mix  – napis z wagami.
+ * @return Wartość @p true, jeśli napis jest poprawny i suma wag jest dodatnia,
+ * a @p false w przeciwnym przypadku.
+ */
+static bool parse_mix(gen_t *gen, const char *mix) {
+    memset(gen->weight, 0, sizeof(gen->weight));
+    uint64_t total = 0;
+    while (*mix != '\0') {
+        const char *pos = memchr(kind_letter, mix[0], KINDS);
+        if (pos == NULL || mix[1] != ':') return false;
+        char *end;
+        unsigned long w = strtoul(mix + 2, &end, 10);
+        if (end == mix + 2 || w > UINT32_MAX) return false;
+        gen->weight[pos - kind_letter] = (uint32_t) w;
+        total += w;
+        mix = end;
+        if (*mix == ',') mix++;
+    }
+    return total > 0;
+}
+
+/* @brief Wczytuje liczbę dodatnią typu uint32_t.
+ * @param[in] s    – napis z liczbą,
+ * @param[out] out – wczytana liczba.
+ * @return Wartość @p true, jeśli napis jest poprawny, a @p false w przeciwnym
+ * przypadku.
+ */
+static bool parse_positive(const char *s, uint32_t *out) {
+    char *end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (end == s || *end != '\0' || v == 0 || v > UINT32_MAX) return false;
+    *out = (uint32_t) v;
+    return true;
+}
+
+/* @brief Wczytuje ułamek z przedziału [0, 1].
+ * @param[in] s    – napis z liczbą,
+ * @param[out] out – wczytana liczba.
+ * @return Wartość @p true, jeśli napis jest poprawny, a @p false w przeciwnym
+ * przypadku.
+ */
+static bool parse_fraction(const char *s, double *out) {
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || *end != '\0' || !(v >= 0.0 && v <= 1.0)) return false;
+    *out = v;
+    return true;
+}
+
+/* @brief Wypisuje sposób użycia programu i kończy go z kodem 1.
+ * @param[in] name – nazwa programu.
+ */
+static void usage(const char *name) {
+    fprintf(stderr,
+            "Użycie: %s [-s ziarno] [-W szerokość] [-H wysokość] [-P gracze]\n"
+            "          [-A obszary] [-n linie] [-m m:60,b:10,f:10,q:19,p:1]\n"
+            "          [-g część_złotych] [-e część_błędnych]\n",
+            name);
+    exit(1);
+}
+
+/* @brief Funkcja main generatora gamma_gen
+ * Na podstawie ziarna wypisuje deterministyczny skrypt trybu wsadowego:
+ * linię "B", a po niej zadaną liczbę poleceń. Wynik jest zapisywany
+ * strumieniowo, więc rozmiar skryptu nie jest ograniczony pamięcią.
+ * @return @p 0 jeśli program wykonał się poprawnie,
+ * a @p 1 jeśli podano niepoprawne argumenty lub zapis się nie powiódł.
+ */
+int main(int argc, char *argv[]) {
+    static gen_t gen = {
+            .seed = 1, .width = 100, .height = 100, .players = 4, .areas = 5,
+            .lines = 1000, .weight = {60, 10, 10, 19, 1},
+            .golden = 0.05, .invalid = 0.01
+    };
+    int opt;
+    while ((opt = getopt(argc, argv, "s:W:H:P:A:n:m:g:e:")) != -1) {
+        char *end;
+        switch (opt) {
+            case 's':
+                gen.seed = strtoull(optarg, &end, 10);
+                if (end == optarg || *end != '\0') usage(argv[0]);
+                break;
+            case 'n':
+                gen.lines = strtoull(optarg, &end, 10);
+                if (end == optarg || *end != '\0') usage(argv[0]);
+                break;
+            case 'W':
+                if (!parse_positive(optarg, &gen.width)) usage(argv[0]);
+                break;
+            case 'H':
+                if (!parse_positive(optarg, &gen.height)) usage(argv[0]);
+                break;
+            case 'P':
+                if (!parse_positive(optarg, &gen.players)) usage(argv[0]);
+                break;
+            case 'A':
+                if (!parse_positive(optarg, &gen.areas)) usage(argv[0]);
+                break;
+            case 'm':
+                if (!parse_mix(&gen, optarg)) usage(argv[0]);
+                break;
+            case 'g':
+                if (!parse_fraction(optarg, &gen.golden)) usage(argv[0]);
+                break;
+            case 'e':
+                if (!parse_fraction(optarg, &gen.invalid)) usage(argv[0]);
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+    if (optind != argc) usage(argv[0]);
+
+    uint64_t total = 0;
+    for (int i = 0; i < KINDS; i++) total += gen.weight[i];
+
+    put_string(&gen, "B ", 2);
+    put_number(&gen, gen.width);
+    put_char(&gen, ' ');
+    put_number(&gen, gen.height);
+    put_char(&gen, ' ');
+    put_number(&gen, gen.players);
+    put_char(&gen, ' ');
+    put_number(&gen, gen.areas);
+    put_char(&gen, '\n');
+
+    for (uint64_t i = 0; i < gen.lines; i++) {
+        if (random_chance(&gen, gen.invalid)) put_invalid(&gen);
+        else put_valid(&gen, random_kind(&gen, total));
+    }
+    flush_out(&gen);
+    return fflush(stdout) == 0 ? 0 : 1;
+}
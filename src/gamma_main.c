@@ -6,11 +6,53 @@
  */
 
 #include "gamma.h"
+#include <errno.h>
+#include <poll.h>
 #include <string.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include <stdint.h>
+#include <unistd.h>
 #include "commands.h"
+#include "latency.h"
+#include "trace.h"
+#include "checkpoint.h"
+#include "wal.h"
+
+/** Histogramy czasów wykonania poleceń trybu wsadowego.
+ */
+static latency_t latency;
+
+/** Czy na koniec programu wypisać histogramy czasów (opcja --latency).
+ */
+static bool latency_on_exit = false;
+
+/** Silnik wybrany opcją --backend lub NULL, gdy wybierany jest automatycznie.
+ */
+static const gamma_backend_t *backend = NULL;
+
+/** Punkt kontrolny, od którego program wznawia grę (opcja --resume), lub NULL.
+ */
+static const char *resume = NULL;
+
+/** Dziennik ruchów (opcja --wal) lub NULL.
+ */
+static const char *wal_log = NULL;
+
+/** Rozmiar bufora standardowego wejścia.
+ */
+#define INPUT_BUFFER (1 << 16)
+
+/** Bufor standardowego wejścia.
+ */
+static char input[INPUT_BUFFER];
+
+/** Liczba bajtów w buforze @ref input.
+ */
+static ssize_t input_size = 0;
+
+/** Indeks następnego nieprzeczytanego bajtu w buforze @ref input.
+ */
+static ssize_t input_index = 0;
 
 /* @brief Funkcja wywoływana na koniec programu
  * Zwania pamięć i kończy program odpowiednim kodem (0 lub 1).
@@ -23,16 +65,21 @@
  * @param[in] index    – indeks, do którego zapełniony jest buffor,
  * @param[in] succesed – czy program ma zakończyć się z kodem 0.
  */
-void final(gamma_t *g, uint32_t *argv, char *buffer,
+void final(gamma_engine_t *g, uint32_t *argv, char *buffer,
            bool enter, uint64_t line, uint64_t index, bool succesed) {
     if (!enter
         && argv != NULL
         && !only_spaces(buffer, index)) {
         fprintf(stderr, "ERROR %lu\n", line);
     }
-    gamma_delete(g);
+    gamma_engine_delete(g);
     if (argv != NULL) free(argv);
     if (buffer != NULL) free(buffer);
+    wal_close();
+    if (latency_on_exit) {
+        fflush(stdout);
+        latency_print(&latency, stderr);
+    }
 
     if (succesed) exit(0);
     else exit(1);
@@ -42,72 +89,250 @@ void final(gamma_t *g, uint32_t *argv, char *buffer,
  * Jeśli pierwsza litera jest jedną z możliwych pierwszych liter polecenia,
  * to próbuje wywołać to polecenie.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] buffer  – buffor, w którym znajduje się polecenie
- * @param[in] argv    – tablica, do której przekazywane są polecenia.
+ * @param[in] command – litera polecenia,
+ * @param[in] argc    – liczba argumentów lub -1 dla niepoprawnej linii,
+ * @param[in] argv    – tablica z argumentami polecenia,
  * @param[in] line    – nr ostatniej linii.
  */
-void batch(gamma_t *g, char *buffer, uint32_t *argv, uint64_t line) {
-    if (buffer[0] == 'm') try_command_m(g, buffer, argv, line);
-    else if (buffer[0] == 'g') try_command_g(g, buffer, argv, line);
-    else if (buffer[0] == 'b') try_command_b(g, buffer, argv, line);
-    else if (buffer[0] == 'f') try_command_f(g, buffer, argv, line);
-    else if (buffer[0] == 'q') try_command_q(g, buffer, argv, line);
-    else if (buffer[0] == 'p') try_command_p(g, buffer, argv, line);
+void batch(gamma_engine_t *g, char command, int32_t argc, uint32_t *argv,
+           uint64_t line) {
+    uint64_t start = latency_now();
+    if (command == 'm') try_command_m(g, argc, argv, line);
+    else if (command == 'g') try_command_g(g, argc, argv, line);
+    else if (command == 'b') try_command_b(g, argc, argv, line);
+    else if (command == 'f') try_command_f(g, argc, argv, line);
+    else if (command == 'q') try_command_q(g, argc, argv, line);
+    else if (command == 'p') try_command_p(g, argc, line);
+    else if (command == 'P') try_command_P(g, argc, line);
+    else if (command == 'r') try_command_r(g, argc, argv, line);
+    else if (command == 'd') try_command_d(g, argc, argv, line);
+    else if (command == 's') try_command_s(g, argc, line);
+    else if (command == 'l') try_command_l(&latency, argc, line);
     else fprintf(stderr, "ERROR %lu\n", line);
+    latency_record(&latency, command, latency_now() - start);
+}
+
+/* @brief Wypisuje sposób użycia programu i kończy go z kodem 1.
+ * @param[in] program  – nazwa programu.
+ */
+void usage(const char *program) {
+    fprintf(stderr, "Użycie: %s [--latency] [--backend NAZWA]"
+            " [--record PLIK | --replay PLIK] [--checkpoint PLIK"
+            " [--checkpoint-moves N] [--checkpoint-ms T]]"
+            " [--resume PLIK | --wal PLIK [--wal-records N] [--wal-us T]]\n",
+            program);
+    exit(1);
+}
+
+/* @brief Wczytuje liczbę będącą wartością opcji.
+ * @param[in] text    – napis z liczbą dziesiętną,
+ * @param[out] value  – liczba.
+ * @return Wartość @p true, jeśli napis jest liczbą mieszczącą się w uint64_t,
+ * a @p false w przeciwnym razie.
+ */
+bool option_number(const char *text, uint64_t *value) {
+    *value = 0;
+    if (*text == '\0') return false;
+    for (; *text != '\0'; text++) {
+        uint64_t digit = (uint64_t) (*text - '0');
+        if (digit > 9 || *value > (UINT64_MAX - digit) / 10) return false;
+        *value = *value * 10 + digit;
+    }
+    return true;
+}
+
+/* @brief Wczytuje opcje programu.
+ * Rozpoznaje opcje:
+ * – --latency, po której na koniec programu na wyjście diagnostyczne
+ *   wypisywane są histogramy czasów wykonania poleceń,
+ * – --backend NAZWA, po której gry trybu wsadowego prowadzi wskazany silnik
+ *   (auto oznacza wybór automatyczny na podstawie parametrów gry),
+ * – --record PLIK, po której wywołania ruchów zapisywane są w śladzie;
+ *   ślad obejmuje tylko gry prowadzone przez silnik gamma_t,
+ * – --checkpoint PLIK, po której gra zapisywana jest w tle jako punkt
+ *   kontrolny co --checkpoint-moves N ruchów lub co --checkpoint-ms T
+ *   milisekund (tylko gry prowadzone przez silnik gamma_t),
+ * – --resume PLIK, po której program wznawia grę z punktu kontrolnego
+ *   w trybie wsadowym i pomija linie wejścia wykonane przed jego zapisem,
+ * – --wal PLIK, po której wykonane ruchy zapisywane są w dzienniku
+ *   utrwalanym na dysku co --wal-records N rekordów lub co --wal-us T
+ *   mikrosekund, a także przed oczekiwaniem na wejście; wyniki poleceń
+ *   wypisywane są dopiero po utrwaleniu dziennika (tylko gry prowadzone
+ *   przez silnik gamma_t); jeśli dziennik
+ *   zawiera już grę, program odtwarza ją i pomija linie wejścia zapisane
+ *   w dzienniku,
+ * – --replay PLIK, po której program odtwarza ślad, wypisuje podsumowanie
+ *   i kończy się z kodem 0, jeśli wyniki są zgodne z zapisem, lub 1.
+ * Dla nieznanej opcji wypisuje sposób użycia i kończy program z kodem 1.
+ * @param[in] argc     – liczba argumentów programu,
+ * @param[in] argv     – argumenty programu.
+ */
+void parse_options(int argc, char *argv[]) {
+    const char *record = NULL, *replay = NULL, *checkpoint = NULL;
+    uint64_t moves = 0, ms = 0, records = 0, us = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--latency") == 0) {
+            latency_on_exit = true;
+        } else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            i++;
+            backend = gamma_backend_find(argv[i]);
+            if (backend == NULL && strcmp(argv[i], "auto") != 0)
+                usage(argv[0]);
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpoint = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint-moves") == 0 && i + 1 < argc
+                   && option_number(argv[i + 1], &moves)) {
+            i++;
+        } else if (strcmp(argv[i], "--checkpoint-ms") == 0 && i + 1 < argc
+                   && option_number(argv[i + 1], &ms)
+                   && ms <= UINT64_MAX / 1000000) {
+            i++;
+        } else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+            resume = argv[++i];
+        } else if (strcmp(argv[i], "--wal") == 0 && i + 1 < argc) {
+            wal_log = argv[++i];
+        } else if (strcmp(argv[i], "--wal-records") == 0 && i + 1 < argc
+                   && option_number(argv[i + 1], &records)) {
+            i++;
+        } else if (strcmp(argv[i], "--wal-us") == 0 && i + 1 < argc
+                   && option_number(argv[i + 1], &us)
+                   && us <= UINT64_MAX / 1000) {
+            i++;
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if ((record != NULL && replay != NULL)
+        || (checkpoint == NULL && (moves != 0 || ms != 0))
+        || (resume != NULL && wal_log != NULL)
+        || (wal_log == NULL && (records != 0 || us != 0)))
+        usage(argv[0]);
+    if (replay != NULL) exit(trace_replay(replay, stdout) ? 0 : 1);
+    if (record != NULL && !trace_open(record)) {
+        fprintf(stderr, "ERROR %s\n", record);
+        exit(1);
+    }
+    if (checkpoint != NULL) checkpoint_start(checkpoint, moves, ms * 1000000);
+    if (wal_log != NULL) wal_start(wal_log, records, us * 1000);
+}
+
+/* @brief Czeka na dane na standardowym wejściu.
+ * Jeśli w dzienniku czekają ruchy lub wyniki, czeka najwyżej do chwili,
+ * w której trzeba je utrwalić, a wtedy utrwala je (@ref wal_flush), zanim
+ * zablokuje się w oczekiwaniu na wejście. Jeśli ta chwila już minęła,
+ * utrwala je od razu. Jeśli utrwalenie się nie powiedzie, kończy program
+ * z kodem 1.
+ * @param[in] line    – nr bieżącej linii.
+ */
+static void wait_input(uint64_t line) {
+    int timeout = wal_timeout();
+    if (timeout < 0) return;
+    struct pollfd in = {0, POLLIN, 0};
+    if ((timeout == 0 || poll(&in, 1, timeout) <= 0) && !wal_flush()) {
+        fprintf(stderr, "ERROR %lu\n", line);
+        exit(1);
+    }
+}
+
+/* @brief Wczytuje kolejny znak ze standardowego wejścia.
+ * Czyta deskryptor 0 bezpośrednio, tak jak tryb interaktywny, żeby przed
+ * zablokowaniem się wiedzieć, czy w buforze zostały jeszcze dane.
+ * @param[in] line    – nr bieżącej linii.
+ * @return Wczytany znak lub EOF.
+ */
+static int next_letter(uint64_t line) {
+    while (input_index == input_size) {
+        wait_input(line);
+        input_size = read(0, input, INPUT_BUFFER);
+        input_index = 0;
+        if (input_size < 0 && errno == EINTR) {
+            input_size = 0;
+        } else if (input_size <= 0) {
+            input_size = 0;
+            return EOF;
+        }
+    }
+    return (unsigned char) input[input_index++];
 }
 
 /* @brief Funkcja main tworzonego pliku wykonywalnego gamma
- * Wczytuje i interpretuje polecenia.
+ * Wczytuje opcje programu, a następnie wczytuje i interpretuje polecenia.
  * @return @p 0 jeśli program wykonał się poprawnie,
  * a @p 1 jeśli wystąpił krytyczny błąd.
  */
-int main(void) {
-    gamma_t *g = NULL; //gra gamma
+int main(int argc, char *argv[]) {
+    gamma_engine_t *g = NULL; //gra gamma
     uint64_t line = 1; //nr lini
-    uint64_t size = 0; //aktualny zaalokowany rozmiar bufora
-    char *buffer = NULL; //bufor przetrzymujący obecne polecenie
+    uint64_t size = 1; //aktualny zaalokowany rozmiar bufora
+    char *buffer = calloc(size, sizeof(char)); //bufor z obecnym poleceniem
     uint64_t index = 0; //rozmiar polecenia
-    char letter; //wczytywana litera
-    uint32_t *argv = malloc(4 * sizeof(uint32_t)); //tu przekażmy argumenty
+    int letter; //wczytywana litera
+    uint32_t *args = malloc(COMMAND_ARGS_MAX * sizeof(uint32_t)); //argumenty
     bool batch_mode = false; //czy barch mode jest włączony
     bool enter = false; //czy linia zakończona jest eneterem
-    bool error = false; //czy podano literę będącą nie liczbą i nie białym znakiem
 
-    if (argv == NULL) final(g, argv, buffer, enter, line, index, false);
+    uint64_t skip = 0; //linie wykonane przed zapisem punktu kontrolnego
+    gamma_t *restored = NULL; //gra z punktu kontrolnego lub z dziennika
+    const char *failed = NULL; //plik, z którego nie udało się odtworzyć gry
 
-    while (scanf("%c", &letter) == 1) {
-        if (size == 0) {//pierwszy znak po końcu linii
-            size = 1;
-            if (buffer != NULL) free(buffer);
-            buffer = calloc(1, size * sizeof(char));
-            if (buffer == NULL) final(g, argv, buffer, enter, line, index, false);
-            index = 0;
+    parse_options(argc, argv);
+    if (args == NULL || buffer == NULL)
+        final(g, args, buffer, enter, line, index, false);
+    if (resume != NULL) {
+        restored = checkpoint_load(resume, &skip);
+        if (restored == NULL) failed = resume;
+    } else if (wal_log != NULL && !wal_recover(&restored, &skip)) {
+        failed = wal_log;
+    }
+    if (restored != NULL) {
+        g = gamma_engine_from_dense(restored);
+        if (g == NULL) {
+            gamma_delete(restored);
+            failed = resume != NULL ? resume : wal_log;
         }
+    }
+    if (failed != NULL) {
+        fprintf(stderr, "ERROR %s\n", failed);
+        final(g, args, buffer, enter, line, index, false);
+    }
+    if (g != NULL) {
+        trace_game(restored);
+        checkpoint_game(restored);
+        batch_mode = true;
+    }
+
+    //bufor jest używany ponownie dla kolejnych linii
+    while ((letter = next_letter(line)) != EOF) {
         if (letter != '\n') {//ciągle ta sama linia
-            if (index != 0 && !good_letter(letter)) error = true;
-            if (!add_letter(&index, &size, &buffer, letter)) {
-                final(g, argv, buffer, enter, line, index, false);
+            if (!add_letter(&index, &size, &buffer, (char) letter)) {
+                final(g, args, buffer, enter, line, index, false);
             }
             enter = false;
             continue;
         }
-        if (buffer[0] == '#' || index == 0) {
-            //Nic się nie dzieje - komentarz lub pusta linia
-        } else if (batch_mode == false) {
-            if (error) fprintf(stderr, "ERROR %lu\n", line);
-            else if (buffer[0] == 'I') try_command_I(&g, buffer, argv, line);
-            else if (buffer[0] == 'B') try_command_B(&g, buffer, argv, line, &batch_mode);
-            else fprintf(stderr, "ERROR %lu\n", line);
+        if (index == 0 || buffer[0] == '#' || line <= skip) {
+            //Nic się nie dzieje - komentarz, pusta linia
+            //lub linia wykonana przed zapisem punktu kontrolnego lub dziennika
         } else {
-            if (error) fprintf(stderr, "ERROR %lu\n", line);
-            else batch(g, buffer, argv, line);
+            int32_t count = parse_arguments(buffer, index, args);
+            if (batch_mode) {
+                batch(g, buffer[0], count, args, line);
+            } else if (buffer[0] == 'I') {
+                try_command_I(buffer, count, args, line);
+            } else if (buffer[0] == 'B') {
+                try_command_B(&g, backend, count, args, line, &batch_mode);
+            } else {
+                fprintf(stderr, "ERROR %lu\n", line);
+            }
         }
         enter = true;
         line++;
-        if (buffer != NULL) free(buffer);
-        buffer = NULL;
-        size = 0;
-        error = false;
+        index = 0;
+        buffer[0] = '\0';
     }
-    final(g, argv, buffer, enter, line, index, true);
+    final(g, args, buffer, enter, line, index, true);
 }
@@ -0,0 +1,91 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "gamma_pool.h"
+
+/* @brief Znajduje kubełek gier o danych wymiarach planszy.
+ * @param[in] pool    – pula,
+ * @param[in] width   – szerokość planszy,
+ * @param[in] height  – wysokość planszy.
+ * @return Wskaźnik na kubełek lub NULL, jeśli go nie ma.
+ */
+static gamma_pool_bucket_t *pool_find(gamma_pool_t *pool, uint32_t width,
+                                      uint32_t height) {
+    for (uint32_t i = 0; i < pool->bucket_count; i++) {
+        gamma_pool_bucket_t *bucket = &pool->buckets[i];
+        if (bucket->width == width && bucket->height == height) return bucket;
+    }
+    return NULL;
+}
+
+/* @brief Tworzy kubełek gier o danych wymiarach planszy.
+ * @param[in,out] pool – pula,
+ * @param[in] width    – szerokość planszy,
+ * @param[in] height   – wysokość planszy.
+ * @return Wskaźnik na kubełek lub NULL, jeśli alokacja nie powiodła się.
+ */
+static gamma_pool_bucket_t *pool_add(gamma_pool_t *pool, uint32_t width,
+                                     uint32_t height) {
+    if (pool->bucket_count == pool->bucket_cap) {
+        uint32_t cap = pool->bucket_cap == 0 ? 4 : 2 * pool->bucket_cap;
+        gamma_pool_bucket_t *buckets =
+                realloc(pool->buckets, cap * sizeof(gamma_pool_bucket_t));
+        if (buckets == NULL) return NULL;
+        pool->buckets = buckets;
+        pool->bucket_cap = cap;
+    }
+    gamma_t **idle = malloc(pool->max_idle * sizeof(gamma_t *));
+    if (idle == NULL) return NULL;
+    gamma_pool_bucket_t *bucket = &pool->buckets[pool->bucket_count++];
+    bucket->width = width;
+    bucket->height = height;
+    bucket->idle = idle;
+    bucket->idle_count = 0;
+    return bucket;
+}
+
+void gamma_pool_init(gamma_pool_t *pool, uint32_t max_idle) {
+    pool->buckets = NULL;
+    pool->bucket_count = 0;
+    pool->bucket_cap = 0;
+    pool->max_idle = max_idle;
+}
+
+void gamma_pool_clear(gamma_pool_t *pool) {
+    for (uint32_t i = 0; i < pool->bucket_count; i++) {
+        gamma_pool_bucket_t *bucket = &pool->buckets[i];
+        for (uint32_t j = 0; j < bucket->idle_count; j++)
+            gamma_delete(bucket->idle[j]);
+        free(bucket->idle);
+    }
+    free(pool->buckets);
+    gamma_pool_init(pool, pool->max_idle);
+}
+
+gamma_t* gamma_pool_get(gamma_pool_t *pool, uint32_t width, uint32_t height,
+                        uint32_t players, uint32_t areas) {
+    gamma_pool_bucket_t *bucket = pool_find(pool, width, height);
+    if (bucket != NULL && bucket->idle_count > 0) {
+        gamma_t *g = bucket->idle[bucket->idle_count - 1];
+        if (!gamma_reset(g, players, areas)) return NULL;
+        bucket->idle_count--;
+        return g;
+    }
+    return gamma_new(width, height, players, areas);
+}
+
+void gamma_pool_put(gamma_pool_t *pool, gamma_t *g) {
+    if (g == NULL) return;
+    gamma_pool_bucket_t *bucket = pool_find(pool, g->width, g->height);
+    if (bucket == NULL && pool->max_idle > 0)
+        bucket = pool_add(pool, g->width, g->height);
+    if (bucket == NULL || bucket->idle_count == pool->max_idle) {
+        gamma_delete(g);
+        return;
+    }
+    bucket->idle[bucket->idle_count++] = g;
+}
@@ -0,0 +1,70 @@
+/** @file
+ * Interfejs puli gier do ponownego użycia
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_POOL_H
+#define GAMMA_POOL_H
+
+#include "gamma.h"
+
+/** @brief Nieużywane gry o tych samych wymiarach planszy.
+ */
+struct gamma_pool_bucket {
+    uint32_t width; ///< szerokość planszy gier kubełka
+    uint32_t height; ///< wysokość planszy gier kubełka
+    gamma_t **idle; ///< nieużywane gry (rozmiar @p max_idle puli)
+    uint32_t idle_count; ///< liczba gier w @p idle
+};
+typedef struct gamma_pool_bucket gamma_pool_bucket_t;
+
+/** @brief Pula gier do ponownego użycia.
+ * Zwrócone do puli gry przechowywane są w kubełkach według wymiarów planszy
+ * i wydawane ponownie po przywróceniu funkcją @ref gamma_reset. Gdy w puli
+ * są gry o potrzebnych wymiarach, wydanie i zwrot gry nie alokują pamięci.
+ */
+struct gamma_pool {
+    gamma_pool_bucket_t *buckets; ///< kubełki
+    uint32_t bucket_count; ///< liczba kubełków
+    uint32_t bucket_cap; ///< rozmiar tablicy @p buckets
+    uint32_t max_idle; ///< największa liczba nieużywanych gier w kubełku
+};
+typedef struct gamma_pool gamma_pool_t;
+
+/** @brief Tworzy pustą pulę.
+ * @param[out] pool    – pula,
+ * @param[in] max_idle – największa liczba nieużywanych gier o tych samych
+ *                       wymiarach planszy; nadmiarowe gry są usuwane.
+ */
+void gamma_pool_init(gamma_pool_t *pool, uint32_t max_idle);
+
+/** @brief Usuwa wszystkie gry z puli i zwalnia jej pamięć.
+ * @param[in,out] pool – pula.
+ */
+void gamma_pool_clear(gamma_pool_t *pool);
+
+/** @brief Wydaje grę w stanie początkowym.
+ * Parametry są takie same jak w @ref gamma_new. Jeśli w puli jest gra
+ * o tych wymiarach planszy, przywraca ją i wydaje, a w przeciwnym razie
+ * tworzy nową.
+ * @param[in,out] pool – pula,
+ * @param[in] width    – szerokość planszy,
+ * @param[in] height   – wysokość planszy,
+ * @param[in] players  – liczba graczy,
+ * @param[in] areas    – maksymalna liczba obszarów jednego gracza.
+ * @return Wskaźnik na grę lub NULL, jak w @ref gamma_new.
+ */
+gamma_t* gamma_pool_get(gamma_pool_t *pool, uint32_t width, uint32_t height,
+                        uint32_t players, uint32_t areas);
+
+/** @brief Zwraca grę do puli.
+ * Gra nie może być dalej używana przez wywołującego. Jeśli kubełek jest
+ * pełny, gra jest usuwana. Nic nie robi, jeśli @p g ma wartość NULL.
+ * @param[in,out] pool – pula,
+ * @param[in] g        – wskaźnik na grę.
+ */
+void gamma_pool_put(gamma_pool_t *pool, gamma_t *g);
+
+#endif /* GAMMA_POOL_H */
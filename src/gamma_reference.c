@@ -0,0 +1,295 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "gamma_reference.h"
+#include <string.h>
+
+/** @brief Stan gry silnika wzorcowego.
+ */
+typedef struct reference {
+    gamma_params_t params; ///< parametry gry
+    uint32_t *board; ///< board[y * width + x] – gracz na polu (x, y) lub 0
+    uint64_t *stack; ///< stos pól do odwiedzenia przy liczeniu obszarów
+    uint64_t *seen; ///< znaczniki pól odwiedzonych przy liczeniu obszarów
+    uint64_t stamp; ///< ostatnio użyty znacznik w @p seen
+    uint32_t *golden; ///< gracze, którzy wykonali złoty ruch
+    uint64_t golden_count; ///< liczba graczy w @p golden
+    uint64_t golden_cap; ///< rozmiar tablicy @p golden
+} reference_t;
+
+/* @brief Podaje liczbę pól planszy.
+ * @param[in] r       – stan gry.
+ * @return Liczba pól.
+ */
+static uint64_t ref_cells(const reference_t *r) {
+    return (uint64_t) r->params.width * r->params.height;
+}
+
+/* @brief Podaje sąsiada pola.
+ * @param[in] r       – stan gry,
+ * @param[in] i       – indeks pola,
+ * @param[in] k       – numer sąsiada: x-1, x+1, y-1, y+1,
+ * @param[out] n      – indeks sąsiada.
+ * @return Wartość @p true, jeśli sąsiad leży na planszy,
+ * a @p false w przeciwnym razie.
+ */
+static bool ref_neighbour(const reference_t *r, uint64_t i, uint32_t k,
+                          uint64_t *n) {
+    uint64_t width = r->params.width;
+    uint64_t x = i % width, y = i / width;
+    if (k == 0 && x > 0) *n = i - 1;
+    else if (k == 1 && x + 1 < width) *n = i + 1;
+    else if (k == 2 && y > 0) *n = i - width;
+    else if (k == 3 && y + 1 < r->params.height) *n = i + width;
+    else return false;
+    return true;
+}
+
+/* @brief Sprawdza, czy obok pola stoi pionek gracza.
+ * @param[in] r       – stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] i       – indeks pola.
+ * @return Wartość @p true, jeśli któryś sąsiad pola należy do gracza,
+ * a @p false w przeciwnym razie.
+ */
+static bool ref_next_to(const reference_t *r, uint32_t player, uint64_t i) {
+    uint64_t n;
+    for (uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++)
+        if (ref_neighbour(r, i, k, &n) && r->board[n] == player) return true;
+    return false;
+}
+
+/* @brief Liczy obszary gracza, przeszukując całą planszę.
+ * @param[in,out] r   – stan gry,
+ * @param[in] player  – numer gracza.
+ * @return Liczba obszarów gracza.
+ */
+static uint64_t ref_areas(reference_t *r, uint32_t player) {
+    uint64_t areas = 0, n;
+    r->stamp++;
+    for (uint64_t i = 0; i < ref_cells(r); i++) {
+        if (r->board[i] != player || r->seen[i] == r->stamp) continue;
+        areas++;
+        uint64_t top = 0;
+        r->stack[top++] = i;
+        r->seen[i] = r->stamp;
+        while (top > 0) {
+            uint64_t j = r->stack[--top];
+            for (uint32_t k = 0; k < GAMMA_NEIGHBOURS; k++) {
+                if (ref_neighbour(r, j, k, &n) && r->board[n] == player
+                    && r->seen[n] != r->stamp) {
+                    r->seen[n] = r->stamp;
+                    r->stack[top++] = n;
+                }
+            }
+        }
+    }
+    return areas;
+}
+
+/* @brief Sprawdza, czy gracz wykonał już złoty ruch.
+ * @param[in] r       – stan gry,
+ * @param[in] player  – numer gracza.
+ * @return Wartość @p true, jeśli gracz wykonał złoty ruch,
+ * a @p false w przeciwnym razie.
+ */
+static bool ref_golden_used(const reference_t *r, uint32_t player) {
+    for (uint64_t i = 0; i < r->golden_count; i++)
+        if (r->golden[i] == player) return true;
+    return false;
+}
+
+/* @brief Sprawdza, czy złoty ruch gracza na pole zmieściłby się w limitach.
+ * Stawia pionek próbnie i liczy obszary obu graczy od nowa.
+ * @param[in,out] r   – stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] i       – indeks pola zajętego przez innego gracza.
+ * @return Wartość @p true, jeśli po ruchu żaden z graczy nie przekroczy
+ * limitu obszarów, a @p false w przeciwnym razie.
+ */
+static bool ref_golden_fits(reference_t *r, uint32_t player, uint64_t i) {
+    uint32_t owner = r->board[i];
+    r->board[i] = player;
+    bool fits = ref_areas(r, player) <= r->params.areas
+                && ref_areas(r, owner) <= r->params.areas;
+    r->board[i] = owner;
+    return fits;
+}
+
+/* @brief Sprawdza poprawność numeru gracza.
+ * @param[in] r       – stan gry,
+ * @param[in] player  – numer gracza.
+ * @return Wartość @p true, jeśli numer jest poprawny,
+ * a @p false w przeciwnym razie.
+ */
+static bool ref_player(const reference_t *r, uint32_t player) {
+    return r != NULL && player >= 1 && player <= r->params.players;
+}
+
+/* @brief Usuwa stan gry silnika wzorcowego.
+ * @param[in] game    – stan gry lub NULL.
+ */
+static void ref_destroy(void *game) {
+    reference_t *r = game;
+    if (r == NULL) return;
+    free(r->board);
+    free(r->stack);
+    free(r->seen);
+    free(r->golden);
+    free(r);
+}
+
+/* @brief Tworzy stan gry silnika wzorcowego.
+ * @param[in] params  – parametry gry.
+ * @return Stan gry lub NULL, gdy któryś z parametrów jest niepoprawny
+ * lub nie udało się zaalokować pamięci.
+ */
+static void *ref_create(const gamma_params_t *params) {
+    if (params->width < 1 || params->height < 1 || params->players < 1
+        || params->players > GAMMA_PLAYERS_MAX || params->areas < 1)
+        return NULL;
+    reference_t *r = calloc(1, sizeof(reference_t));
+    if (r == NULL) return NULL;
+    r->params = *params;
+    r->board = calloc(ref_cells(r), sizeof(uint32_t));
+    r->stack = malloc(ref_cells(r) * sizeof(uint64_t));
+    r->seen = calloc(ref_cells(r), sizeof(uint64_t));
+    if (r->board == NULL || r->stack == NULL || r->seen == NULL) {
+        ref_destroy(r);
+        return NULL;
+    }
+    return r;
+}
+
+/* @brief Wykonuje ruch, jak @ref gamma_move. */
+static bool ref_move(void *game, uint32_t player, uint32_t x, uint32_t y) {
+    reference_t *r = game;
+    if (!ref_player(r, player) || x >= r->params.width
+        || y >= r->params.height)
+        return false;
+    uint64_t i = (uint64_t) y * r->params.width + x;
+    if (r->board[i] != 0) return false;
+    if (!ref_next_to(r, player, i) && ref_areas(r, player) >= r->params.areas)
+        return false;
+    r->board[i] = player;
+    return true;
+}
+
+/* @brief Wykonuje złoty ruch, jak @ref gamma_golden_move. */
+static bool ref_golden_move(void *game, uint32_t player,
+                            uint32_t x, uint32_t y) {
+    reference_t *r = game;
+    if (!ref_player(r, player) || x >= r->params.width
+        || y >= r->params.height || ref_golden_used(r, player))
+        return false;
+    uint64_t i = (uint64_t) y * r->params.width + x;
+    if (r->board[i] == 0 || r->board[i] == player
+        || !ref_golden_fits(r, player, i))
+        return false;
+    if (r->golden_count == r->golden_cap) {
+        uint64_t cap = r->golden_cap == 0 ? 4 : 2 * r->golden_cap;
+        uint32_t *golden = realloc(r->golden, cap * sizeof(uint32_t));
+        if (golden == NULL) return false;
+        r->golden = golden;
+        r->golden_cap = cap;
+    }
+    r->golden[r->golden_count++] = player;
+    r->board[i] = player;
+    return true;
+}
+
+/* @brief Liczy pola gracza, jak @ref gamma_busy_fields. */
+static uint64_t ref_busy_fields(void *game, uint32_t player) {
+    reference_t *r = game;
+    if (!ref_player(r, player)) return 0;
+    uint64_t busy = 0;
+    for (uint64_t i = 0; i < ref_cells(r); i++)
+        if (r->board[i] == player) busy++;
+    return busy;
+}
+
+/* @brief Liczy pola dostępne dla gracza, jak @ref gamma_free_fields. */
+static uint64_t ref_free_fields(void *game, uint32_t player) {
+    reference_t *r = game;
+    if (!ref_player(r, player)) return 0;
+    bool limited = ref_areas(r, player) >= r->params.areas;
+    uint64_t free_fields = 0;
+    for (uint64_t i = 0; i < ref_cells(r); i++)
+        if (r->board[i] == 0 && (!limited || ref_next_to(r, player, i)))
+            free_fields++;
+    return free_fields;
+}
+
+/* @brief Sprawdza możliwość złotego ruchu, jak @ref gamma_golden_possible.
+ */
+static bool ref_golden_possible(void *game, uint32_t player) {
+    reference_t *r = game;
+    if (!ref_player(r, player) || ref_golden_used(r, player)) return false;
+    for (uint64_t i = 0; i < ref_cells(r); i++)
+        if (r->board[i] != 0 && r->board[i] != player
+            && ref_golden_fits(r, player, i))
+            return true;
+    return false;
+}
+
+/* @brief Wypisuje pole planszy do bufora.
+ * @param[out] dst    – bufor o rozmiarze co najmniej 13 znaków,
+ * @param[in] player  – gracz na polu lub 0.
+ * @return Liczba zapisanych znaków.
+ */
+static int ref_cell(char *dst, uint32_t player) {
+    if (player == 0) return sprintf(dst, ".");
+    if (player < 10) return sprintf(dst, "%u", player);
+    return sprintf(dst, " %u ", player);
+}
+
+/* @brief Opisuje planszę, jak @ref gamma_board. */
+static char *ref_board(void *game) {
+    reference_t *r = game;
+    if (r == NULL) return NULL;
+    char cell[16];
+    uint64_t length = r->params.height;
+    for (uint64_t i = 0; i < ref_cells(r); i++)
+        length += ref_cell(cell, r->board[i]);
+
+    char *board = malloc(length + 1);
+    if (board == NULL) return NULL;
+    char *d = board;
+    for (uint32_t y = r->params.height; y-- > 0; ) {
+        for (uint32_t x = 0; x < r->params.width; x++)
+            d += ref_cell(d, r->board[(uint64_t) y * r->params.width + x]);
+        *d++ = '\n';
+    }
+    *d = '\0';
+    return board;
+}
+
+/* @brief Wypisuje planszę, jak @ref gamma_board_write. */
+static bool ref_board_write(void *game, FILE *out) {
+    if (out == NULL) return false;
+    char *board = ref_board(game);
+    if (board == NULL) return false;
+    bool written = fputs(board, out) != EOF;
+    free(board);
+    return written;
+}
+
+const gamma_backend_t gamma_reference_backend = {
+    .name = "reference",
+    .automatic = false,
+    .max_cells = REFERENCE_MAX_CELLS,
+    .max_players = 0,
+    .create = ref_create,
+    .destroy = ref_destroy,
+    .move = ref_move,
+    .golden_move = ref_golden_move,
+    .busy_fields = ref_busy_fields,
+    .free_fields = ref_free_fields,
+    .golden_possible = ref_golden_possible,
+    .board = ref_board,
+    .board_write = ref_board_write,
+};
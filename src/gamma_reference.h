@@ -0,0 +1,27 @@
+/** @file
+ * Interfejs wzorcowego silnika gry gamma
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_REFERENCE_H
+#define GAMMA_REFERENCE_H
+
+#include "gamma.h"
+
+/** Największa liczba pól planszy obsługiwana przez silnik wzorcowy.
+ * Sprawdzenie możliwości złotego ruchu zlicza obszary od nowa dla każdego
+ * pola, więc działa w czasie kwadratowym względem liczby pól.
+ */
+#define REFERENCE_MAX_CELLS (1 << 12)
+
+/** @brief Silnik wzorcowy.
+ * Pamięta tylko planszę i listę graczy, którzy wykonali złoty ruch.
+ * Liczby obszarów i pól wyznacza przy każdym wywołaniu, przeglądając całą
+ * planszę, wprost według zasad gry. Służy do sprawdzania innych silników
+ * (gamma_diff) i nigdy nie jest wybierany automatycznie.
+ */
+extern const gamma_backend_t gamma_reference_backend;
+
+#endif /* GAMMA_REFERENCE_H */
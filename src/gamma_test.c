@@ -86,6 +86,16 @@ int main() {
  assert(gamma_free_fields(g, 1) == 8);
  assert(gamma_busy_fields(g, 2) == 4);
  assert(gamma_free_fields(g, 2) == 10);
+ assert(gamma_next_player(g, 1) == 2);
+ assert(gamma_next_player(g, 2) == 1);
+ gamma_area_t areas[3];
+ assert(gamma_areas(g, 2, areas, 3) == 3);
+ assert(areas[0].size + areas[1].size + areas[2].size == 4);
+ gamma_standing_t standings[3];
+ assert(gamma_standings(g, standings, 3) == 2);
+ assert(standings[0].player == 1 && standings[0].busy == 5);
+ assert(standings[1].player == 2 && standings[1].busy == 4);
+ assert(!gamma_game_over(g));
 
  char *p = gamma_board(g);
  assert(p);
@@ -93,6 +103,71 @@ int main() {
  printf("%s", p);
  free(p);
 
+ gamma_delete(g);
+
+ assert(gamma_new(10, 10, UINT32_MAX, 1) == NULL);
+ assert(gamma_new(UINT32_MAX, UINT32_MAX, 2, 2) == NULL);
+ g = gamma_new(10, 10, GAMMA_PLAYERS_MAX, 1);
+ assert(g != NULL);
+ assert(gamma_move(g, GAMMA_PLAYERS_MAX, 0, 0));
+ assert(gamma_busy_fields(g, GAMMA_PLAYERS_MAX) == 1);
+ assert(gamma_free_fields(g, 1) == 99);
+ assert(gamma_next_player(g, GAMMA_PLAYERS_MAX) == 1);
+ assert(gamma_owner(g, 0, 0) == GAMMA_PLAYERS_MAX);
+ assert(gamma_owner(g, 10, 0) == 0);
+
+ assert(!gamma_reset(g, 2, 0));
+ assert(gamma_reset(g, 2, 1));
+ assert(gamma_owner(g, 0, 0) == 0);
+ assert(gamma_busy_fields(g, 1) == 0);
+ assert(gamma_free_fields(g, 1) == 100);
+ assert(gamma_move(g, 2, 9, 9));
+ assert(!gamma_move(g, 2, 0, 0));
+ assert(gamma_busy_fields(g, 2) == 1);
+ gamma_delete(g);
+
+ g = gamma_new(4, 4, 3, 1);
+ assert(g != NULL);
+ assert(gamma_move(g, 1, 0, 0));
+ assert(gamma_move(g, 1, 1, 0));
+ assert(gamma_move(g, 1, 2, 0));
+ assert(gamma_move(g, 1, 2, 1));
+ assert(gamma_move(g, 1, 2, 2));
+ assert(gamma_move(g, 1, 1, 2));
+ assert(gamma_move(g, 1, 0, 2));
+ assert(gamma_move(g, 1, 0, 1));
+ assert(gamma_move(g, 1, 3, 1));
+ assert(gamma_golden_move(g, 2, 1, 0));
+ assert(!gamma_golden_move(g, 3, 0, 1));
+ assert(!gamma_golden_move(g, 3, 2, 1));
+ assert(gamma_golden_move(g, 3, 0, 0));
+ gamma_delete(g);
+
+ // Liczenie pól w prostokątach dużej planszy z kilkoma pionkami nie może
+ // alokować pamięci rzędu liczby pól.
+ uint32_t side = 8000;
+ uint64_t cells = (uint64_t)side * side;
+ uint64_t blocks = (side + GAMMA_RECT_BLOCK - 1) / GAMMA_RECT_BLOCK;
+ g = gamma_new(side, side, 8, 2);
+ assert(g != NULL);
+ for (uint32_t p = 1; p <= 8; p++)
+   assert(gamma_move(g, p, 400 * p + p, 450 * p));
+ for (uint32_t round = 0; round < 3; round++) {
+   for (uint32_t p = 0; p <= 8; p++) {
+     uint64_t all = p == 0 ? cells - 8 : 1;
+     assert(gamma_rect_count(g, p, 0, 0, side - 1, side - 1) == all);
+     assert(gamma_rect_count(g, p, 3, 7, side - 5, side - 9)
+            == (p == 0 ? (uint64_t)(side - 7) * (side - 15) - 8 : 1));
+     assert(gamma_rect_count(g, p, 400 * p + p, 0, side - 1, 450 * p)
+            == (p == 0 ? side : 1));
+   }
+ }
+ assert(g->rect_tree_count > 0);
+ assert(g->rect_tree_count * blocks * blocks * sizeof(uint64_t) <= cells / 2);
+ assert(gamma_golden_move(g, 2, 401, 450));
+ assert(gamma_rect_count(g, 1, 0, 0, side - 1, side - 1) == 0);
+ assert(gamma_rect_count(g, 2, 0, 0, side - 1, side - 1) == 2);
+ assert(gamma_rect_count(g, 0, 0, 0, side - 1, side - 1) == cells - 8);
  gamma_delete(g);
  return 0;
   }
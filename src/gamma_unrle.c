@@ -0,0 +1,109 @@
+/* @file
+ * Dekoder planszy wypisanej poleceniem P trybu wsadowego gry gamma
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** Rozmiar bufora wyjścia.
+ */
+#define OUT_BUFFER (1 << 20)
+
+/* @brief Wczytuje liczbę dziesiętną.
+ * @param[out] value  – liczba,
+ * @param[out] next   – pierwszy znak za liczbą.
+ * @return Wartość @p true, jeśli wczytano co najmniej jedną cyfrę i liczba
+ * mieści się w uint64_t, a @p false w przeciwnym razie.
+ */
+static bool read_number(uint64_t *value, int *next) {
+    int c = getchar();
+    *value = 0;
+    if (c < '0' || c > '9') return false;
+    for (; c >= '0' && c <= '9'; c = getchar()) {
+        uint64_t digit = (uint64_t) (c - '0');
+        if (*value > (UINT64_MAX - digit) / 10) return false;
+        *value = *value * 10 + digit;
+    }
+    *next = c;
+    return true;
+}
+
+/* @brief Wypisuje serię pól w postaci takiej jak gamma_board.
+ * @param[in] player  – numer gracza lub 0 dla wolnych pól,
+ * @param[in] length  – liczba pól serii,
+ * @param[in] width   – szerokość planszy,
+ * @param[in,out] x   – numer kolumny kolejnego pola.
+ */
+static void put_run(uint64_t player, uint64_t length, uint64_t width,
+                    uint64_t *x) {
+    char text[24];
+    int n;
+    if (player == 0) n = sprintf(text, ".");
+    else if (player < 10) n = sprintf(text, "%lu", player);
+    else n = sprintf(text, " %lu ", player);
+    for (uint64_t i = 0; i < length; i++) {
+        fwrite(text, 1, (size_t) n, stdout);
+        if (++*x == width) {
+            putchar('\n');
+            *x = 0;
+        }
+    }
+}
+
+/* @brief Dekoduje planszę, której linia nagłówka zaczyna się od 'R'.
+ * Wczytuje resztę nagłówka "R <szerokość> <wysokość>" i linię serii pól,
+ * a wypisuje planszę w postaci takiej jak gamma_board.
+ * @return Wartość @p true, jeśli plansza jest poprawna, a @p false,
+ * gdy zapis jest niepoprawny lub serie nie pokrywają dokładnie planszy.
+ */
+static bool decode_board(void) {
+    uint64_t width, height, x = 0, done = 0;
+    int next;
+    if (getchar() != ' ' || !read_number(&width, &next) || next != ' '
+        || !read_number(&height, &next) || next != '\n' || width == 0
+        || height == 0 || width > UINT32_MAX || height > UINT32_MAX)
+        return false;
+    uint64_t cells = width * height;
+    do {
+        uint64_t player, length = 1;
+        if (!read_number(&player, &next) || player > UINT32_MAX
+            || (next == '*' && (!read_number(&length, &next) || length < 2))
+            || length > cells - done || (next != ' ' && next != '\n'))
+            return false;
+        put_run(player, length, width, &x);
+        done += length;
+    } while (next == ' ');
+    return done == cells;
+}
+
+/* @brief Funkcja main dekodera gamma_unrle.
+ * Przepisuje standardowe wejście na standardowe wyjście, zastępując każdą
+ * planszę wypisaną poleceniem P (linia "R <szerokość> <wysokość>" i linia
+ * serii pól) planszą w postaci, w jakiej wypisuje ją polecenie p.
+ * Pozostałe linie przepisywane są bez zmian.
+ * @return @p 0 jeśli wszystkie plansze są poprawne,
+ * a @p 1 w przeciwnym razie.
+ */
+int main(void) {
+    static char out[OUT_BUFFER];
+    setvbuf(stdout, out, _IOFBF, OUT_BUFFER);
+    int c;
+    while ((c = getchar()) != EOF) {
+        if (c == 'R') {
+            if (!decode_board()) {
+                fflush(stdout);
+                fprintf(stderr, "ERROR\n");
+                return 1;
+            }
+            continue;
+        }
+        for (; c != EOF && c != '\n'; c = getchar()) putchar(c);
+        if (c == '\n') putchar('\n');
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "golden_worker.h"
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+/* @brief Odtwarza w kopii gry jedną zmianę pola.
+ * Zmiana pustego pola to zwykły ruch, a zmiana zajętego pola – złoty ruch.
+ * @param[in,out] replica – kopia gry,
+ * @param[in] change      – zmiana pola.
+ * @return Wartość @p true, jeśli ruch udało się wykonać,
+ * a @p false w przeciwnym razie.
+ */
+static bool replay(gamma_t *replica, const gamma_change_t *change) {
+    if (gamma_owner(replica, change->x, change->y) == 0)
+        return gamma_move(replica, change->player, change->x, change->y);
+    return gamma_golden_move(replica, change->player, change->x, change->y);
+}
+
+/* @brief Pętla wątku liczącego.
+ * Czeka na zlecenie, odtwarza w kopii gry przekazane zmiany pól i liczy
+ * wynik. Wynik zapisuje tylko wtedy, gdy liczenie nie zostało przerwane
+ * i w międzyczasie nie pojawiło się nowe zlecenie.
+ * @param[in,out] arg – wątek (golden_worker_t).
+ * @return Wartość NULL.
+ */
+static void *worker_main(void *arg) {
+    golden_worker_t *w = arg;
+    change_feed_t changes = {NULL, 0, 0, 0};
+
+    pthread_mutex_lock(&w->lock);
+    while (true) {
+        while (!w->job && !w->quit) pthread_cond_wait(&w->wake, &w->lock);
+        if (w->quit) break;
+
+        change_feed_take(&w->feed, &changes);
+        uint32_t player = w->job_player;
+        uint64_t version = w->job_version;
+        w->job = false;
+        atomic_store(&w->cancel, false);
+        pthread_mutex_unlock(&w->lock);
+
+        bool replayed = true;
+        for (uint64_t i = 0; i < changes.count && replayed; i++)
+            replayed = replay(w->replica, &changes.changes[i]);
+
+        bool value = false;
+        bool computed = replayed
+                && gamma_golden_possible_cancellable(w->replica, player,
+                                                     &w->cancel, &value);
+
+        pthread_mutex_lock(&w->lock);
+        if (!replayed) {
+            w->failed = true;
+            break;
+        }
+        if (computed && !w->job) {
+            w->done = true;
+            w->done_player = player;
+            w->done_version = version;
+            w->done_value = value;
+            if (write(w->pipe[1], "", 1) < 0) {
+                //potok jest pełny, więc powiadomienie już na nas czeka
+            }
+        }
+    }
+    pthread_mutex_unlock(&w->lock);
+    change_feed_free(&changes);
+    return NULL;
+}
+
+bool golden_worker_start(golden_worker_t *w, gamma_t *g) {
+    memset(w, 0, sizeof(*w));
+    w->pipe[0] = w->pipe[1] = -1;
+    if (g == NULL || gamma_version(g) != 0) return false;
+
+    w->replica = gamma_new(g->width, g->height, g->players, g->areas);
+    if (w->replica == NULL) return false;
+    if (pipe(w->pipe) == -1) {
+        gamma_delete(w->replica);
+        return false;
+    }
+    fcntl(w->pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(w->pipe[1], F_SETFL, O_NONBLOCK);
+    atomic_init(&w->cancel, false);
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->wake, NULL);
+
+    if (pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+        pthread_mutex_destroy(&w->lock);
+        pthread_cond_destroy(&w->wake);
+        close(w->pipe[0]);
+        close(w->pipe[1]);
+        gamma_delete(w->replica);
+        return false;
+    }
+    w->running = true;
+    return true;
+}
+
+void golden_worker_stop(golden_worker_t *w) {
+    if (!w->running) return;
+    pthread_mutex_lock(&w->lock);
+    w->quit = true;
+    atomic_store(&w->cancel, true);
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->wake);
+    close(w->pipe[0]);
+    close(w->pipe[1]);
+    gamma_delete(w->replica);
+    change_feed_free(&w->feed);
+    w->running = false;
+}
+
+bool golden_worker_request(golden_worker_t *w, gamma_t *g, uint32_t player) {
+    if (!w->running) return false;
+    pthread_mutex_lock(&w->lock);
+    if (w->failed || !change_feed_sync(&w->feed, g)) {
+        //zmiany, których nie udało się przekazać, nie wrócą już do kopii
+        w->failed = true;
+        pthread_mutex_unlock(&w->lock);
+        return false;
+    }
+    w->job = true;
+    w->job_player = player;
+    w->job_version = w->feed.synced;
+    w->done = false;
+    atomic_store(&w->cancel, true);
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    return true;
+}
+
+int golden_worker_fd(golden_worker_t *w) {
+    return w->running ? w->pipe[0] : -1;
+}
+
+bool golden_worker_result(golden_worker_t *w, uint64_t *version,
+                          uint32_t *player, bool *value) {
+    if (!w->running) return false;
+    char drain[64];
+    while (read(w->pipe[0], drain, sizeof(drain)) > 0) {}
+
+    pthread_mutex_lock(&w->lock);
+    bool done = w->done;
+    if (done) {
+        *version = w->done_version;
+        *player = w->done_player;
+        *value = w->done_value;
+        w->done = false;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return done;
+}
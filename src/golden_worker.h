@@ -0,0 +1,93 @@
+/** @file
+ * Interfejs wątku liczącego w tle wynik gamma_golden_possible
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef GOLDEN_WORKER_H
+#define GOLDEN_WORKER_H
+
+#include "gamma.h"
+#include "change_feed.h"
+#include <pthread.h>
+
+/** @brief Wątek liczący w tle, czy gracz może wykonać złoty ruch.
+ * Wątek ma własną kopię gry (@p replica), którą doprowadza do wersji
+ * zlecenia, odtwarzając zmiany pól z dziennika zmian gry. Dzięki temu liczy
+ * na spójnym stanie, a gra może się w tym czasie zmieniać. Nowe zlecenie
+ * przerywa liczenie poprzedniego. O gotowym wyniku wątek informuje, zapisując
+ * bajt do potoku, którego koniec do odczytu można obserwować funkcją poll().
+ */
+struct golden_worker {
+    pthread_t thread; ///< wątek liczący
+    pthread_mutex_t lock; ///< chroni pola zlecenia i wyniku
+    pthread_cond_t wake; ///< sygnalizuje nowe zlecenie lub koniec pracy
+    bool running; ///< czy wątek został uruchomiony
+    bool quit; ///< czy wątek ma zakończyć pracę
+    bool failed; ///< czy nie udało się przekazać lub odtworzyć zmian pól
+    atomic_bool cancel; ///< czy przerwać bieżące liczenie
+
+    gamma_t *replica; ///< kopia gry, na której liczy wątek
+    change_feed_t feed; ///< zmiany pól jeszcze nieodtworzone w kopii
+
+    bool job; ///< czy czeka nowe zlecenie
+    uint32_t job_player; ///< gracz, którego dotyczy zlecenie
+    uint64_t job_version; ///< wersja gry, której dotyczy zlecenie
+
+    bool done; ///< czy jest nieodebrany wynik
+    uint32_t done_player; ///< gracz, którego dotyczy wynik
+    uint64_t done_version; ///< wersja gry, której dotyczy wynik
+    bool done_value; ///< wynik gamma_golden_possible
+
+    int pipe[2]; ///< potok powiadomień o gotowym wyniku
+};
+typedef struct golden_worker golden_worker_t;
+
+/** @brief Uruchamia wątek liczący dla gry @p g.
+ * Gra musi być w stanie początkowym – kopia tworzona jest funkcją
+ * @ref gamma_new z tymi samymi parametrami.
+ * @param[out] w      – uruchamiany wątek,
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli udało się uruchomić wątek,
+ * a @p false w przeciwnym razie.
+ */
+bool golden_worker_start(golden_worker_t *w, gamma_t *g);
+
+/** @brief Przerywa liczenie, kończy wątek i zwalnia jego zasoby.
+ * Nic nie robi, jeśli wątek nie został uruchomiony.
+ * @param[in,out] w   – wątek.
+ */
+void golden_worker_stop(golden_worker_t *w);
+
+/** @brief Zleca policzenie gamma_golden_possible dla bieżącej wersji gry.
+ * Przekazuje wątkowi zmiany pól od poprzedniego zlecenia i przerywa
+ * liczenie, które jeszcze trwa.
+ * @param[in,out] w   – wątek,
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza.
+ * @return Wartość @p true, jeśli zlecenie zostało przyjęte, a @p false, gdy
+ * wątek nie działa albo nie udało się przekazać zmian pól – wtedy wynik
+ * trzeba policzyć samemu.
+ */
+bool golden_worker_request(golden_worker_t *w, gamma_t *g, uint32_t player);
+
+/** @brief Podaje deskryptor, który staje się gotowy do odczytu z wynikiem.
+ * @param[in] w       – wątek.
+ * @return Deskryptor lub -1, jeśli wątek nie działa.
+ */
+int golden_worker_fd(golden_worker_t *w);
+
+/** @brief Odbiera gotowy wynik.
+ * Opróżnia potok powiadomień.
+ * @param[in,out] w     – wątek,
+ * @param[out] version  – wersja gry, której dotyczy wynik,
+ * @param[out] player   – gracz, którego dotyczy wynik,
+ * @param[out] value    – wynik gamma_golden_possible.
+ * @return Wartość @p true, jeśli był nieodebrany wynik,
+ * a @p false w przeciwnym razie.
+ */
+bool golden_worker_result(golden_worker_t *w, uint64_t *version,
+                          uint32_t *player, bool *value);
+
+#endif /* GOLDEN_WORKER_H */
@@ -7,26 +7,161 @@
 
 #include "interactive.h"
 
-static struct termios old, curr;
+/** Czas podświetlenia pola po ruchu (w nanosekundach).
+ */
+#define FLASH_NS 30000000ULL
 
-/* @brief Pobiera znak bez wypisywania go.
- * @return pobrany znak.
+/** Czas, po którym samotny znak ESC uznawany jest za kompletny klawisz
+ * (w milisekundach).
  */
-char getch() {
-    if (tcgetattr(0, &old) == -1) exit(1);
-    curr = old;
-    curr.c_lflag &= ~ECHO;
-    curr.c_lflag &= ~ICANON;
-    if (tcsetattr(0, TCSANOW, &curr) == -1) exit(1);
-    char ch = getchar();
-    if (tcsetattr(0, TCSANOW, &old) == -1) exit(1);
-    return ch;
+#define ESCAPE_TIMEOUT_MS 50
+
+/** Liczba wierszy terminala pod planszą: pusty wiersz i statystyki gracza.
+ */
+#define PANEL_ROWS 5
+
+/** Ustawienia terminala sprzed wejścia w tryb interaktywny.
+ */
+static struct termios old;
+
+/** Czy terminal jest w trybie surowym.
+ */
+static bool raw_mode = false;
+
+/** Ekran, na którym rysowana jest plansza i statystyki gracza.
+ */
+static screen_t screen;
+
+/** Wątek liczący w tle, czy gracz może wykonać złoty ruch.
+ */
+static golden_worker_t worker;
+
+/** @brief Wartość wiersza "Golden move" w statystykach gracza.
+ */
+struct golden_line {
+    uint64_t version; ///< wersja gry, której dotyczy wartość
+    uint32_t player; ///< gracz, którego dotyczy wartość
+    bool known; ///< czy wartość jest już policzona
+    bool value; ///< wynik gamma_golden_possible
+};
+
+/** Wyświetlana wartość wiersza "Golden move".
+ */
+static struct golden_line golden;
+
+/** Czy od ostatniego rysowania zmienił się rozmiar terminala.
+ */
+static volatile sig_atomic_t resized = 0;
+
+/** @brief Widoczny fragment planszy.
+ */
+struct view {
+    uint32_t x; ///< pozycja x-owa lewego górnego widocznego pola
+    uint32_t y; ///< pozycja y-owa lewego górnego widocznego pola
+    uint32_t cols; ///< liczba widocznych kolumn planszy
+    uint32_t rows; ///< liczba widocznych wierszy planszy
+};
+
+/** Fragment planszy wyświetlany na ekranie.
+ */
+static struct view view;
+
+/** @brief Podświetlenie pola po ruchu.
+ */
+struct flash {
+    bool active; ///< czy podświetlenie jest widoczne
+    uint32_t x; ///< pozycja x-owa podświetlonego pola
+    uint32_t y; ///< pozycja y-owa podświetlonego pola
+    uint8_t attr; ///< kolor podświetlenia
+    uint64_t deadline; ///< chwila, w której podświetlenie znika
+};
+
+/** Trwające podświetlenie pola po ruchu.
+ */
+static struct flash flash;
+
+/** @brief Klawisze rozpoznawane w trybie interaktywnym.
+ * Zwykłe znaki reprezentowane są przez swój kod (0–255).
+ */
+enum key {
+    KEY_UP = 256, ///< strzałka w górę
+    KEY_DOWN, ///< strzałka w dół
+    KEY_RIGHT, ///< strzałka w prawo
+    KEY_LEFT, ///< strzałka w lewo
+    KEY_PAGE_UP, ///< klawisz Page Up
+    KEY_PAGE_DOWN, ///< klawisz Page Down
+    KEY_HOME, ///< klawisz Home
+    KEY_END ///< klawisz End
+};
+
+/** @brief Stan dekodera sekwencji klawiszy.
+ */
+enum decoder_state {
+    DECODER_NORMAL, ///< oczekiwanie na nowy klawisz
+    DECODER_ESCAPE, ///< wczytano ESC
+    DECODER_CSI, ///< wczytano ESC [ i ewentualnie pierwszy parametr
+    DECODER_CSI_REST, ///< wczytano ESC [ i separator kolejnego parametru
+    DECODER_SS3 ///< wczytano ESC O
+};
+
+/** @brief Dekoder sekwencji klawiszy.
+ */
+struct decoder {
+    enum decoder_state state; ///< stan dekodera
+    uint32_t param; ///< pierwszy parametr sekwencji ESC [
+};
+
+/* @brief Przywraca ustawienia terminala sprzed trybu interaktywnego.
+ * Wywoływana przy każdym zakończeniu programu.
+ */
+void restore_terminal() {
+    if (raw_mode) {
+        tcsetattr(0, TCSANOW, &old);
+        raw_mode = false;
+    }
+}
+
+/* @brief Obsługuje sygnał przerywający program.
+ * Przywraca ustawienia terminala, pokazuje kursor i kończy program z kodem 1.
+ * @param[in] sig     – numer sygnału.
+ */
+void interrupt_handler(int sig) {
+    (void) sig;
+    if (raw_mode) tcsetattr(0, TCSANOW, &old);
+    if (write(STDOUT_FILENO, "\033[0m\033[?25h\n", 11) < 0) _exit(1);
+    _exit(1);
 }
 
-/* @brief Czyści wszystkie widoczne linijki.
+/* @brief Obsługuje zmianę rozmiaru terminala.
+ * Zaznacza jedynie, że widok trzeba ułożyć na nowo – robi to pętla zdarzeń.
+ * @param[in] sig     – numer sygnału.
  */
-void clear_all() {
-    printf("\e[1;1H\e[2J");
+void resize_handler(int sig) {
+    (void) sig;
+    resized = 1;
+}
+
+/* @brief Przełącza terminal w tryb surowy na czas całej rozgrywki.
+ * Wyłącza echo i tryb kanoniczny, a read() zwraca od razu wszystkie
+ * dostępne znaki. Ustawienia są przywracane przy zakończeniu programu.
+ */
+void enter_raw_mode() {
+    if (tcgetattr(0, &old) == -1) exit(1);
+    struct termios raw = old;
+    raw.c_lflag &= ~(ECHO | ICANON);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(0, TCSANOW, &raw) == -1) exit(1);
+    raw_mode = true;
+    atexit(restore_terminal);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = interrupt_handler;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    action.sa_handler = resize_handler;
+    sigaction(SIGWINCH, &action, NULL);
 }
 
 /* @brief Ukrywa kursor.
@@ -59,238 +194,175 @@ void clear_line() {
     printf("\033[0K");
 }
 
-/* @brief Przesuwa kusor na pozyję gracza o współrzędnych x oraz y.
- * @param[in] x       – pozycja x-owa gracza,
- * @param[in] y       – pozycja y-owa gracza,
- * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
- */
-void move_to_player_position(uint32_t x, uint32_t y, uint32_t length) {
-    move_to(1 + x * (length + 1), 1 + y);
-}
-
 /* @brief Przesuwa kusor w miejsce wypisywania statystyk gracza.
- * @param[in] g       – wskaźnik na strukturę gamma_t,
  */
-void move_to_player_stats(gamma_t *g) {
-    move_to(0, g->height + 2);
+void move_to_player_stats() {
+    move_to(0, view.rows + 2);
 }
 
-/* @brief Wypisuje nr gracza, który nie jest obecnie podświetlany.
- * Nadpisuje tekst - wypisuje nr gracza.
+/* @brief Rysuje w buforze ekranu pole (x, y) z zadanym atrybutem.
+ * Pola spoza widocznego fragmentu planszy są pomijane.
+ * Zera rysuje jako '.'. Jeśli jest więcej niż 9 graczy, to po polu
+ * (poza ostatnią kolumną) rysuje spację bez atrybutu.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  * @param[in] x       – pozycja x-owa gracza,
  * @param[in] y       – pozycja y-owa gracza,
- * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
- */
-void print_normal(gamma_t *g, uint32_t x, uint32_t y, uint32_t length) {
-    if (g->board[x][y] == 0)
-        printf("%*s", length, ".");
-    else
-        printf("%*" PRIu32, length, g->board[x][y]);
-    if (g->players > 9 && x != g->width - 1)
-        printf(" ");
-}
-
-/* @brief Wypisuje nr gracza, który jest obecnie podświetlany.
- * Zamienia kolor tła z kolorem czcionki,
- * nadpisuje tekst - wypisuje nr gracza,
- * oraz zmienia kolor tła i czcionki na początkowe.
- * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] x       – pozycja x-owa gracza,
- * @param[in] y       – pozycja y-owa gracza,
- * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
- */
-void print_reversed(gamma_t *g, uint32_t x, uint32_t y, uint32_t length) {
-    printf("\033[7m");
-    if (g->board[x][y] == 0)
-        printf("%*s", length, ".");
-    else
-        printf("%*" PRIu32, length, g->board[x][y]);
-    printf("\033[0m");
-    if (g->players > 9 && x != g->width - 1)
-        printf(" ");
-}
-
-/* @brief Wypisuje nr gracza, po błędnym ruchu.
- * Zmienia kolor tła na czerwony i nadpisuje tekst - wypisuje nr gracza.
- * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] x       – pozycja x-owa gracza,
- * @param[in] y       – pozycja y-owa gracza,
- * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
- */
-void print_red(gamma_t *g, uint32_t x, uint32_t y, uint32_t length) {
-    printf("\033[41m\033[37m");
-    if (g->board[x][y] == 0)
-        printf("%*s", length, ".");
+ * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami,
+ * @param[in] attr    – atrybut wyświetlania pola.
+ */
+void draw_cell(gamma_t *g, uint32_t x, uint32_t y, uint32_t length,
+               uint8_t attr) {
+    if (x < view.x || x - view.x >= view.cols
+        || y < view.y || y - view.y >= view.rows)
+        return;
+    uint32_t col = (x - view.x) * (length + 1);
+    uint32_t row = y - view.y;
+    uint32_t owner = gamma_owner(g, x, y);
+    if (owner == 0)
+        screen_print(&screen, col, row, attr, "%*s", length, ".");
     else
-        printf("%*" PRIu32, length, g->board[x][y]);
-    printf("\033[0m");
+        screen_print(&screen, col, row, attr, "%*" PRIu32, length, owner);
     if (g->players > 9 && x != g->width - 1)
-        printf(" ");
+        screen_put(&screen, col + length, row, " ", 1, SCREEN_NORMAL);
 }
 
-/* @brief Wypisuje nr gracza, po błędnym ruchu.
- * Zmienia kolor tła na zielony i nadpisuje tekst - wypisuje nr gracza.
- * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] x       – pozycja x-owa gracza,
- * @param[in] y       – pozycja y-owa gracza,
- * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
+/* @brief Wysyła do terminala zmiany narysowane od ostatniej klatki.
+ * Kończy program z kodem 1, jeśli zapis się nie powiódł.
  */
-void print_green(gamma_t *g, uint32_t x, uint32_t y, uint32_t length) {
-    printf("\033[42m\033[37m");
-    if (g->board[x][y] == 0)
-        printf("%*s", length, ".");
-    else
-        printf("%*" PRIu32, length, g->board[x][y]);
-    printf("\033[0m");
-    if (g->players > 9 && x != g->width - 1)
-        printf(" ");
+void present() {
+    if (!screen_flush(&screen)) exit(1);
 }
 
 /* @brief Wypisuje na planszy gracza, który jest obecnie podświetlany.
- * Przesuwa kursor w odpowiednie miejsce na planszy,
- * zamienia kolor tła z kolorem czcionki,
- * nadpisuje znajdujący się w tym miejscu tekst - wstawia w to miejsce nr gracza
- * oraz zmienia kolor tła i czcionki na początkowe.
+ * Nie zmienia pola, które jest właśnie podświetlone po ruchu.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  * @param[in] x       – pozycja x-owa gracza,
  * @param[in] y       – pozycja y-owa gracza,
  * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
  */
 void set_reversed_player(gamma_t *g, uint32_t x, uint32_t y, uint32_t length) {
-    move_to_player_position(x, y, length);
-    print_reversed(g, x, y, length);
+    if (flash.active && flash.x == x && flash.y == y) return;
+    draw_cell(g, x, y, length, SCREEN_REVERSED);
 }
 
 
 /* @brief Wypisuje na planszy gracza, który nie jest obecnie podświetlany.
- * Przesuwa kursor w odpowiednie miejsce na planszy i nadpisuje
- * znajdujący się w tym miejscu tekst - wstawia w to miejsce numer gracza.
+ * Nie zmienia pola, które jest właśnie podświetlone po ruchu.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  * @param[in] x       – pozycja x-owa gracza,
  * @param[in] y       – pozycja y-owa gracza,
  * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
  */
 void set_normal_player(gamma_t *g, uint32_t x, uint32_t y, uint32_t length) {
-    move_to_player_position(x, y, length);
-    print_normal(g, x, y, length);
+    if (flash.active && flash.x == x && flash.y == y) return;
+    draw_cell(g, x, y, length, SCREEN_NORMAL);
 }
 
-/* @brief Wypisuje (czerwone tło) na planszy gracza, który wykonał błędny ruch.
- * Przesuwa kursor w odpowiednie miejsce na planszy i nadpisuje
- * znajdujący się w tym miejscu tekst - wstawia w to miejsce numer gracza.
+/* @brief Kończy podświetlenie pola po ruchu.
+ * Przywraca polu wygląd zależny od tego, czy stoi na nim kursor.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] x       – pozycja x-owa gracza,
- * @param[in] y       – pozycja y-owa gracza,
+ * @param[in] act_x   – pozycja x-owa aktualnie podświetlanego pola,
+ * @param[in] act_y   – pozycja y-owa aktualnie podświetlanego pola,
  * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
  */
-void set_red_player(gamma_t *g, uint32_t x, uint32_t y, uint32_t length) {
-    move_to_player_position(x, y, length);
-    print_red(g, x, y, length);
+void end_flash(gamma_t *g, uint32_t act_x, uint32_t act_y, uint32_t length) {
+    if (!flash.active) return;
+    flash.active = false;
+    if (flash.x == act_x && flash.y == act_y)
+        set_reversed_player(g, flash.x, flash.y, length);
+    else
+        set_normal_player(g, flash.x, flash.y, length);
 }
 
-/* @brief Wypisuje (zielone tło) na planszy gracza, który wykonał błędny ruch.
- * Przesuwa kursor w odpowiednie miejsce na planszy i nadpisuje
- * znajdujący się w tym miejscu tekst - wstawia w to miejsce numer gracza.
+/* @brief Podświetla pole na czas @ref FLASH_NS.
+ * Nie czeka na koniec podświetlenia – kończy je pętla zdarzeń.
+ * Poprzednie podświetlenie, jeśli jeszcze trwa, jest kończone od razu.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] x       – pozycja x-owa gracza,
- * @param[in] y       – pozycja y-owa gracza,
- * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
+ * @param[in] x       – pozycja x-owa pola,
+ * @param[in] y       – pozycja y-owa pola,
+ * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami,
+ * @param[in] attr    – kolor podświetlenia.
  */
-void set_green_player(gamma_t *g, uint32_t x, uint32_t y, uint32_t length) {
-    move_to_player_position(x, y, length);
-    print_green(g, x, y, length);
+void start_flash(gamma_t *g, uint32_t x, uint32_t y, uint32_t length,
+                 uint8_t attr) {
+    end_flash(g, x, y, length);
+    flash.active = true;
+    flash.x = x;
+    flash.y = y;
+    flash.attr = attr;
+    flash.deadline = latency_now() + FLASH_NS;
+    draw_cell(g, x, y, length, attr);
 }
 
-/* @brief Podświetla pole gracza, który wykonał błędy ruch.
- * Podświetla pole gracza, który wykonał błędny ruch na czerwono,
- * a po 0.3 sekundy zamienia spowrotem kolor na odwrócony.
+/* @brief Podświetla na czerwono pole gracza, który wykonał błędny ruch.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  * @param[in] x       – pozycja x-owa gracza,
  * @param[in] y       – pozycja y-owa gracza,
  * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
  */
 void bad_move(gamma_t *g, uint32_t x, uint32_t y, uint32_t length) {
-    set_red_player(g, x, y, length);
-    printf("\a\n");
-    if (tcgetattr(0, &old) == -1) exit(1);
-
-    curr = old;
-    curr.c_lflag &= ~ECHO;
-    curr.c_lflag &= ICANON;
-    curr.c_lflag &= ECHOK;
-    if (tcsetattr(0, TCSANOW, &curr) == -1) exit(1);
-
-    struct timespec tim, tim2;
-    tim.tv_sec = 0;
-    tim.tv_nsec = 30000000;
-    if (nanosleep(&tim, &tim2) < 0) {
-        exit(1);
-    } else {
-        set_reversed_player(g, x, y, length);
-    }
-    if (tcsetattr(0, TCSANOW, &old) == -1) exit(1);
-    fflush(stdin);
+    printf("\a");
+    start_flash(g, x, y, length, SCREEN_RED);
 }
 
-/* @brief Podświetla pole gracza, który wykonał poprawny ruch.
- * Podświetla pole gracza, który wykonał poprawny ruch na zielono,
- * a po 0.3 sekundy zamienia spowrotem kolor na odwrócony.
+/* @brief Podświetla na zielono pole gracza, który wykonał poprawny ruch.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  * @param[in] x       – pozycja x-owa gracza,
  * @param[in] y       – pozycja y-owa gracza,
  * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
  */
 void good_move(gamma_t *g, uint32_t x, uint32_t y, uint32_t length) {
-    set_green_player(g, x, y, length);
-    printf("\n");
-    if (tcgetattr(0, &old) == -1) exit(1);
-
-    curr = old;
-    curr.c_lflag &= ~ECHO;
-    curr.c_lflag &= ICANON;
-    curr.c_lflag &= ECHOK;
-    if (tcsetattr(0, TCSANOW, &curr) == -1) exit(1);
+    start_flash(g, x, y, length, SCREEN_GREEN);
+}
 
-    struct timespec tim, tim2;
-    tim.tv_sec = 0;
-    tim.tv_nsec = 30000000;
-    if (nanosleep(&tim, &tim2) < 0) {
-        exit(1);
-    } else {
-        set_reversed_player(g, x, y, length);
-    }
-    if (tcsetattr(0, TCSANOW, &old) == -1) exit(1);
-    fflush(stdin);
+/* @brief Ustala wartość wiersza "Golden move" dla gracza @p player.
+ * Jeśli wartość dla bieżącej wersji gry i gracza nie jest znana, to liczy ją
+ * od razu, gdy jest to tanie (gracz wykorzystał złoty ruch, nie ma cudzych
+ * pól lub wynik jest w podsumowaniu silnika), a w przeciwnym razie zleca ją
+ * wątkowi liczącemu. Liczy ją od razu także wtedy, gdy wątek nie działa.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] player  – numer gracza.
+ */
+void request_golden(gamma_t *g, uint32_t player) {
+    if (golden.version == gamma_version(g) && golden.player == player) return;
+    golden.version = gamma_version(g);
+    golden.player = player;
+    golden.known = gamma_golden_known(g, player)
+                   || !golden_worker_request(&worker, g, player);
+    if (golden.known) golden.value = gamma_golden_possible(g, player);
 }
 
 /* @brief Wypisuje nr gracza i dotyczące go atrybuty.
- * Przesuwa kursor w odpowiednie miejsce, czyści inijkę oraz wypisuje:
+ * Czyści w buforze ekranu wiersze pod planszą oraz rysuje w nich:
  * numer gracza @p player, gamma_busy_fields i gamma_free_fields dla @p player
- * oraz 'G' jeśli gamma_golden_possible dla @p player zwróciło @p true.
+ * oraz wynik gamma_golden_possible dla @p player, a jeśli nie jest on
+ * jeszcze policzony – "...".
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  * @param[in] player  – numer gracza,
  * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
  */
 void print_player_during_game(gamma_t *g, uint32_t player, uint32_t length) {
-    move_to_player_stats(g);
+    uint32_t row = view.rows + 1;
     if (g->players > 9) length++;
-    uint32_t total_length = (length * g->width) / 2;
+    uint32_t total_length = (length * view.cols) / 2;
     if (total_length < 18) total_length = 18;
 
-    clear_line();
-    printf("%*s", total_length, "Player: ");
-    printf("\e[1m%u\n\e[0m", player);
-    clear_line();
-    printf("%*s", total_length, "Busy fields: ");
-    printf("\e[1m%lu\n\e[0m", gamma_busy_fields(g, player));
-    clear_line();
-    printf("%*s", total_length, "Available fields: ");
-    printf("\e[1m%lu\n\e[0m", gamma_free_fields(g, player));
-    clear_line();
-    printf("%*s", total_length, "Golden move: ");
-    if (gamma_golden_possible(g, player)) printf("\e[1mYes\e[0m");
-    else printf("\e[1mNo\e[0m");
+    for (uint32_t i = 0; i < 4; i++) screen_clear_row(&screen, 0, row + i);
+    screen_print(&screen, 0, row, SCREEN_NORMAL, "%*s", total_length, "Player: ");
+    screen_print(&screen, total_length, row, SCREEN_BOLD, "%u", player);
+    screen_print(&screen, 0, row + 1, SCREEN_NORMAL, "%*s", total_length,
+                 "Busy fields: ");
+    screen_print(&screen, total_length, row + 1, SCREEN_BOLD, "%lu",
+                 gamma_busy_fields(g, player));
+    screen_print(&screen, 0, row + 2, SCREEN_NORMAL, "%*s", total_length,
+                 "Available fields: ");
+    screen_print(&screen, total_length, row + 2, SCREEN_BOLD, "%lu",
+                 gamma_free_fields(g, player));
+    screen_print(&screen, 0, row + 3, SCREEN_NORMAL, "%*s", total_length,
+                 "Golden move: ");
+    request_golden(g, player);
+    screen_print(&screen, total_length, row + 3, SCREEN_BOLD, "%s",
+                 !golden.known ? "..." : golden.value ? "Yes" : "No");
 }
 
 
@@ -302,77 +374,62 @@ void print_player_during_game(gamma_t *g, uint32_t player, uint32_t length) {
  * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
  */
 void print_players_end_of_game(gamma_t *g, uint32_t length) {
-    move_to_player_stats(g);
+    move_to_player_stats();
     if (g->players > 9) length++;
-    uint32_t total_length = (length * g->width) / 2;
+    uint32_t total_length = (length * view.cols) / 2;
     if (total_length < 18) total_length = 18;
 
     printf("%*s", total_length, "Player  ");
     printf("Result\n");
 
-    uint32_t max_busy = 0;
-    for (uint32_t p = 1; p <= g->players; p++) {
-        if (gamma_busy_fields(g, p) > max_busy)
-            max_busy = gamma_busy_fields(g, p);
-    }
+    gamma_standing_t best = {0, 0};
+    gamma_standings(g, &best, 1);
     for (uint32_t p = 1; p <= g->players; p++) {
+        uint64_t busy = gamma_busy_fields(g, p);
         clear_line();
         printf("%*" PRIu32, total_length - 2, p);
         printf("  ");
-        if (gamma_busy_fields(g, p) == max_busy)
-            printf("%lu 👑\n", gamma_busy_fields(g, p));
+        if (busy == best.busy)
+            printf("%lu 👑\n", busy);
         else
-            printf("%lu\n", gamma_busy_fields(g, p));
+            printf("%lu\n", busy);
     }
     clear_line();
     printf("\n");
 }
 
-/* @brief Wypisuje planszę dla obecnego stanu gry.
- * Czyści wszysko, przesuwa kursor na początek oraz wypisuje planszę,
- * tak aby na pozycji (1, 1) rozpoczynał się napis oznaczający gracza (0, 0).
- * Zera wypisuje jako '.'.
- * Jeśli jest więcej niż 9 graczy, to między kolumnami wypisuje spacje.
+/* @brief Rysuje planszę dla obecnego stanu gry.
+ * Rysuje w buforze ekranu tylko widoczny fragment planszy tak, aby w lewym
+ * górnym rogu rozpoczynał się napis oznaczający pole (view.x, view.y).
+ * Pole podświetlone po ruchu rysuje w kolorze podświetlenia.
+ * Zera rysuje jako '.'.
+ * Jeśli jest więcej niż 9 graczy, to między kolumnami rysuje spacje.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  * @param[in] act_x   – pozycja x-owa aktualnie podświetlanego pola,
  * @param[in] act_y   – pozycja y-owa aktualnie podświetlanego pola,
  * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
  */
 void print_gamma(gamma_t *g, uint32_t length, uint32_t act_x, uint32_t act_y) {
-    clear_all();
-    for (uint32_t y = 0; y < g->height; y++) {
-        for (uint32_t x = 0; x < g->width; x++) {
-            if (x == act_x && y == act_y) print_reversed(g, x, y, length);
-            else print_normal(g, x, y, length);
+    for (uint32_t y = view.y; y < view.y + view.rows; y++) {
+        for (uint32_t x = view.x; x < view.x + view.cols; x++) {
+            if (flash.active && x == flash.x && y == flash.y)
+                draw_cell(g, x, y, length, flash.attr);
+            else if (x == act_x && y == act_y)
+                set_reversed_player(g, x, y, length);
+            else
+                set_normal_player(g, x, y, length);
         }
-        printf("\n");
     }
 }
 
 /* @brief Zmienia nr gracza na pierwszego kolejnego, który może wykonać ruch.
- * Znajduje pierwszego w kolejności rozgrywki gracza po graczu @p p,
- * dla którego gamma_free_fields zwróciło dodatnią liczbę
- * lub gamma_golden_possible zwróciło @p true.
+ * Kolejnego gracza wyznacza gamma_next_player.
  * Jeśli taki gracz nie istnieje, to ustawia @p p na @p 0;
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  * @param[out] p      – gracz, który aktualnie wykonuje ruch.
  */
 void next_player(gamma_t *g, uint32_t *p) {
-    uint32_t start_p = *p;
-    if (*p == g->players) *p = 1;
-    else (*p)++;
-
-    while (gamma_free_fields(g, *p) == 0 && !gamma_golden_possible(g, *p)) {
-        if (*p == g->players) *p = 1;
-        else (*p)++;
-
-        if (*p == start_p
-            && gamma_free_fields(g, *p) == 0
-            && !gamma_golden_possible(g, *p)) {
-            *p = 0;
-            return;
-        }
-    }
+    *p = gamma_next_player(g, *p);
 }
 
 /* @brief Kończy działanie interactive_mode.
@@ -384,7 +441,11 @@ void next_player(gamma_t *g, uint32_t *p) {
  * @param[in] y       – pozycja y-owa aktualnie podświetlanego pola.
  */
 void end_interactive_game(gamma_t *g, uint32_t length, uint32_t x, uint32_t y) {
+    flash.active = false;
     set_normal_player(g, x, y, length);
+    present();
+    screen_free(&screen);
+    golden_worker_stop(&worker);
     print_players_end_of_game(g, length);
     gamma_delete(g);
     show_cursor();
@@ -455,21 +516,128 @@ void try_arrow_left(gamma_t *g, uint32_t *x, uint32_t *y, uint32_t length) {
     }
 }
 
-/* @brief Sprawdza czy ostatnio wczytana sekwencja znaków jest strzałką.
- * Zakłada, że dwa znaki temu wpisano ESC, a znak temu '['.
- * Sprawdza, czy obecnie wczytany znak to A, B, C lub D. Jeśli tak, to wywołuje
+/* @brief Obsługuje strzałkę.
+ * Jeśli @p key to KEY_UP, KEY_DOWN, KEY_RIGHT lub KEY_LEFT, to wywołuje
  * odpowiednio: try_arrow_up, try_arrow_down, try_arrow_right, try_arrow_left.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  * @param[in] x       – pozycja x-owa aktualnie podświetlanego pola,
  * @param[in] y       – pozycja y-owa aktualnie podświetlanego pola,
  * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami,
- * @param[in] ch      – ostatnio wczytany znak.
+ * @param[in] key     – klawisz.
  */
-void try_arrows(gamma_t *g, uint32_t *x, uint32_t *y, uint32_t length, char ch) {
-    if (ch == 'A') try_arrow_up(g, x, y, length);
-    else if (ch == 'B') try_arrow_down(g, x, y, length);
-    else if (ch == 'C') try_arrow_right(g, x, y, length);
-    else if (ch == 'D') try_arrow_left(g, x, y, length);
+void try_arrows(gamma_t *g, uint32_t *x, uint32_t *y, uint32_t length, int key) {
+    if (key == KEY_UP) try_arrow_up(g, x, y, length);
+    else if (key == KEY_DOWN) try_arrow_down(g, x, y, length);
+    else if (key == KEY_RIGHT) try_arrow_right(g, x, y, length);
+    else if (key == KEY_LEFT) try_arrow_left(g, x, y, length);
+}
+
+/* @brief Przeskakuje podświetleniem pola o stronę lub na skraj planszy.
+ * Page Up i Page Down przesuwają podświetlenie i widok o liczbę widocznych
+ * wierszy, a Home i End przenoszą podświetlenie na początek i koniec wiersza.
+ * Widok dopasowuje do nowej pozycji funkcja follow_cursor.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] x       – pozycja x-owa aktualnie podświetlanego pola,
+ * @param[in] y       – pozycja y-owa aktualnie podświetlanego pola,
+ * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami,
+ * @param[in] key     – klawisz.
+ */
+void try_jumps(gamma_t *g, uint32_t *x, uint32_t *y, uint32_t length, int key) {
+    uint32_t new_x = *x, new_y = *y;
+    if (key == KEY_PAGE_UP) {
+        new_y = (*y > view.rows) ? *y - view.rows : 0;
+        view.y = (view.y > view.rows) ? view.y - view.rows : 0;
+    } else if (key == KEY_PAGE_DOWN) {
+        new_y = (g->height - 1 - *y > view.rows) ? *y + view.rows : g->height - 1;
+        view.y += view.rows;
+        if (view.y > g->height - view.rows) view.y = g->height - view.rows;
+    } else if (key == KEY_HOME) {
+        new_x = 0;
+    } else if (key == KEY_END) {
+        new_x = g->width - 1;
+    } else {
+        return;
+    }
+    set_normal_player(g, *x, *y, length);
+    *x = new_x;
+    *y = new_y;
+    set_reversed_player(g, *x, *y, length);
+}
+
+/* @brief Przesuwa widok tak, aby podświetlone pole było widoczne.
+ * Widok przesuwany jest o najmniejszą potrzebną liczbę pól.
+ * Jeśli widok się zmienił, to rysuje na nowo jego zawartość.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami,
+ * @param[in] act_x   – pozycja x-owa aktualnie podświetlanego pola,
+ * @param[in] act_y   – pozycja y-owa aktualnie podświetlanego pola,
+ * @param[in] moved   – czy widok został już przesunięty.
+ */
+void follow_cursor(gamma_t *g, uint32_t length, uint32_t act_x, uint32_t act_y,
+                   bool moved) {
+    uint32_t old_x = view.x, old_y = view.y;
+    if (act_x < view.x) view.x = act_x;
+    else if (act_x - view.x >= view.cols) view.x = act_x - view.cols + 1;
+    if (act_y < view.y) view.y = act_y;
+    else if (act_y - view.y >= view.rows) view.y = act_y - view.rows + 1;
+    if (moved || view.x != old_x || view.y != old_y)
+        print_gamma(g, length, act_x, act_y);
+}
+
+/* @brief Dekoduje kolejny bajt wejścia.
+ * Rozpoznaje strzałki wysyłane jako ESC [ A–D lub ESC O A–D,
+ * Home i End wysyłane jako ESC [ H/F, ESC O H/F, ESC [ 1/7 ~ i ESC [ 4/8 ~
+ * oraz Page Up i Page Down wysyłane jako ESC [ 5 ~ i ESC [ 6 ~.
+ * Pozostałe sekwencje ESC [ są pomijane, a znak po samotnym ESC
+ * traktowany jest jak zwykły znak.
+ * @param[in,out] d     – dekoder,
+ * @param[in] byte      – wczytany bajt.
+ * @return Rozpoznany klawisz lub -1, jeśli sekwencja nie jest jeszcze
+ * kompletna lub została pominięta.
+ */
+int decode_key(struct decoder *d, unsigned char byte) {
+    switch (d->state) {
+        case DECODER_NORMAL:
+            if (byte == '\e') {
+                d->state = DECODER_ESCAPE;
+                return -1;
+            }
+            return byte;
+        case DECODER_ESCAPE:
+            d->param = 0;
+            if (byte == '[') d->state = DECODER_CSI;
+            else if (byte == 'O') d->state = DECODER_SS3;
+            else if (byte != '\e') d->state = DECODER_NORMAL;
+            return (d->state == DECODER_NORMAL) ? byte : -1;
+        case DECODER_CSI:
+            if (byte >= '0' && byte <= '9') {
+                if (d->param < 1000) d->param = d->param * 10 + (byte - '0');
+                return -1;
+            }
+            // fall through
+        case DECODER_CSI_REST:
+            if (byte >= 0x20 && byte < 0x40) {//parametry sekwencji
+                d->state = DECODER_CSI_REST;
+                return -1;
+            }
+            // fall through
+        case DECODER_SS3:
+            d->state = DECODER_NORMAL;
+            if (byte >= 'A' && byte <= 'D') {
+                static const int arrows[] = {KEY_UP, KEY_DOWN, KEY_RIGHT, KEY_LEFT};
+                return arrows[byte - 'A'];
+            }
+            if (byte == 'H') return KEY_HOME;
+            if (byte == 'F') return KEY_END;
+            if (byte == '~') {
+                if (d->param == 1 || d->param == 7) return KEY_HOME;
+                if (d->param == 4 || d->param == 8) return KEY_END;
+                if (d->param == 5) return KEY_PAGE_UP;
+                if (d->param == 6) return KEY_PAGE_DOWN;
+            }
+            return -1;
+    }
+    return -1;
 }
 
 /* @brief Wykonuje złoty ruch (o ile się da)
@@ -481,10 +649,10 @@ void try_arrows(gamma_t *g, uint32_t *x, uint32_t *y, uint32_t length, char ch)
  * @param[in] p       – gracz, który próbuje wykonać ruch.
  */
 void try_GM(gamma_t *g, uint32_t x, uint32_t y, uint32_t length, uint32_t *p) {
-    if (gamma_golden_move(g, *p, x, y)) {
+    if (trace_golden_move(g, *p, x, y)) {
         good_move(g, x, y, length);
+        if (gamma_game_over(g)) end_interactive_game(g, length, x, y);
         next_player(g, p);
-        if (*p == 0) end_interactive_game(g, length, x, y);
         print_player_during_game(g, *p, length);
     } else {
         bad_move(g, x, y, length);
@@ -500,10 +668,10 @@ void try_GM(gamma_t *g, uint32_t x, uint32_t y, uint32_t length, uint32_t *p) {
  * @param[in] p       – gracz, który próbuje wykonać ruch.
  */
 void try_M(gamma_t *g, uint32_t x, uint32_t y, uint32_t length, uint32_t *p) {
-    if (gamma_move(g, *p, x, y)) {
+    if (trace_move(g, *p, x, y)) {
         good_move(g, x, y, length);
+        if (gamma_game_over(g)) end_interactive_game(g, length, x, y);
         next_player(g, p);
-        if (*p == 0) end_interactive_game(g, length, x, y);
         print_player_during_game(g, *p, length);
     } else {
         bad_move(g, x, y, length);
@@ -511,17 +679,18 @@ void try_M(gamma_t *g, uint32_t x, uint32_t y, uint32_t length, uint32_t *p) {
 }
 
 /* @brief Sprawdza, czy terminal ma odpowiedni rozmiar
- * Jeśli terminal jest zbyt mayły, to kończy rozgrywkę i wypisuje komunikat.
- * @param[in] g       – wskaźnik na strukturę gamma_t,
- * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami.
+ * Plansza nie musi mieścić się w terminalu – wyświetlany jest jej fragment.
+ * Jeśli w terminalu nie mieści się jedno pole ze statystykami gracza,
+ * to kończy rozgrywkę i wypisuje komunikat.
+ * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami,
+ * @param[out] size   – rozmiar terminala.
  */
-void check_win_size(gamma_t *g, uint32_t length) {
-    struct winsize max;
-    ioctl(0, TIOCGWINSZ, &max);
+void check_win_size(uint32_t length, struct winsize *size) {
+    memset(size, 0, sizeof(*size));
+    ioctl(0, TIOCGWINSZ, size);
     length++;
-    if (max.ws_col < g->width * length
-        || max.ws_col < 18 + length
-        || max.ws_row < g->height + 5) {
+    if (size->ws_col < 18 + length
+        || size->ws_row < 1 + PANEL_ROWS) {
         printf("\033[91m\033[47m");
         printf("Za mały terminal!");
         printf("\033[0m\n");
@@ -529,47 +698,143 @@ void check_win_size(gamma_t *g, uint32_t length) {
     }
 }
 
+/* @brief Dopasowuje widok do rozmiaru terminala.
+ * Wyznacza liczbę widocznych kolumn i wierszy planszy, a następnie przesuwa
+ * widok tak, aby nie wychodził poza planszę.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami,
+ * @param[in] size    – rozmiar terminala.
+ */
+void fit_view(gamma_t *g, uint32_t length, const struct winsize *size) {
+    view.cols = size->ws_col / (length + 1);
+    if (view.cols == 0) view.cols = 1;
+    if (view.cols > g->width) view.cols = g->width;
+    view.rows = (size->ws_row > PANEL_ROWS) ? size->ws_row - PANEL_ROWS : 1;
+    if (view.rows > g->height) view.rows = g->height;
+    if (view.x > g->width - view.cols) view.x = g->width - view.cols;
+    if (view.y > g->height - view.rows) view.y = g->height - view.rows;
+}
+
+/* @brief Układa ekran na nowo po zmianie rozmiaru terminala.
+ * Zachowuje lewy górny róg widoku na tyle, na ile pozwala nowy rozmiar,
+ * i rysuje od nowa planszę oraz statystyki gracza.
+ * @param[in] g       – wskaźnik na strukturę gamma_t,
+ * @param[in] length  – długość, jaką ma zająć napis gracza razem ze spacjami,
+ * @param[in] act_x   – pozycja x-owa aktualnie podświetlanego pola,
+ * @param[in] act_y   – pozycja y-owa aktualnie podświetlanego pola,
+ * @param[in] player  – gracz, który aktualnie wykonuje ruch.
+ */
+void relayout(gamma_t *g, uint32_t length, uint32_t act_x, uint32_t act_y,
+              uint32_t player) {
+    struct winsize size;
+    memset(&size, 0, sizeof(size));
+    ioctl(0, TIOCGWINSZ, &size);
+    if (size.ws_col == 0 || size.ws_row == 0) return;
+    screen_free(&screen);
+    if (!screen_init(&screen, size.ws_col, size.ws_row)) exit(1);
+    fit_view(g, length, &size);
+    follow_cursor(g, length, act_x, act_y, true);
+    print_player_during_game(g, player, length);
+}
+
 void interactive_mode(gamma_t *g) {
     uint32_t act_player = 1;
 
     uint32_t length = snprintf(NULL, 0, "%" PRIu32, g->players);
     if (g->players <= 9) length--;
-    check_win_size(g, length);
+    struct winsize size;
+    check_win_size(length, &size);
 
     uint32_t act_x = (g->width - 1) / 2;
     uint32_t act_y = (g->height) / 2;
 
+    if (!screen_init(&screen, size.ws_col, size.ws_row)) exit(1);
+    golden_worker_start(&worker, g);
+    fit_view(g, length, &size);
+    view.x = (act_x > view.cols / 2) ? act_x - view.cols / 2 : 0;
+    view.y = (act_y > view.rows / 2) ? act_y - view.rows / 2 : 0;
+    fit_view(g, length, &size);
+
     hide_cursor();
     print_gamma(g, length, act_x, act_y);
     print_player_during_game(g, 1, length);
+    present();
 
-    bool entered_escape = false;
-    bool entered_bracket = false;
-    char ch;
+    enter_raw_mode();
+    struct decoder decoder = {.state = DECODER_NORMAL, .param = 0};
+    uint64_t escape_time = 0;
+    unsigned char input[256];
 
     while (true) {
-        ch = getch();
-        if (ch == '\e') {//pierwszy znak strzałki
-            entered_escape = true;
-            entered_bracket = false;
-        } else if (ch == '[' && entered_escape == true) {//drugi znak strzałki
-            if (entered_bracket == false) entered_bracket = true;
-            else entered_escape = false;
-        } else {
-            if (ch == 4) {//Ctrl + D
+        int timeout = -1;
+        if (flash.active) {
+            uint64_t now = latency_now();
+            timeout = flash.deadline > now
+                      ? (int) ((flash.deadline - now + 999999) / 1000000) : 0;
+        }
+        if (decoder.state == DECODER_ESCAPE
+            && (timeout < 0 || timeout > ESCAPE_TIMEOUT_MS))
+            timeout = ESCAPE_TIMEOUT_MS;
+
+        struct pollfd pfd[2] = {
+                {.fd = 0, .events = POLLIN},
+                {.fd = golden_worker_fd(&worker), .events = POLLIN}
+        };
+        int ready = resized ? -1 : poll(pfd, 2, timeout);
+        if (ready < 0 && errno != EINTR && !resized) exit(1);
+        if (resized) {
+            resized = 0;
+            relayout(g, length, act_x, act_y, act_player);
+            present();
+            continue;
+        }
+
+        uint64_t version;
+        uint32_t player;
+        bool value;
+        if (ready > 0 && (pfd[1].revents & POLLIN)
+            && golden_worker_result(&worker, &version, &player, &value)
+            && !golden.known && version == golden.version
+            && player == golden.player) {
+            golden.known = true;
+            golden.value = value;
+            print_player_during_game(g, act_player, length);
+        }
+
+        ssize_t count = 0;
+        if (ready > 0 && (pfd[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+            count = read(0, input, sizeof(input));
+            if (count < 0 && errno != EINTR && errno != EAGAIN) exit(1);
+            if (count == 0) end_interactive_game(g, length, act_x, act_y);
+        }
+        if (count <= 0 && decoder.state == DECODER_ESCAPE
+            && latency_now() - escape_time >= ESCAPE_TIMEOUT_MS * 1000000ULL)
+            decoder.state = DECODER_NORMAL;
+
+        for (ssize_t i = 0; i < count; i++) {
+            int key = decode_key(&decoder, input[i]);
+            if (decoder.state == DECODER_ESCAPE) escape_time = latency_now();
+            if (key < 0) continue;
+            if (key == 4) {//Ctrl + D
                 end_interactive_game(g, length, act_x, act_y);
-            } else if (ch == ' ') {//zwykły ruch
+            } else if (key == ' ') {//zwykły ruch
                 try_M(g, act_x, act_y, length, &act_player);
-            } else if (ch == 'G' || ch == 'g') {//złoty ruch
+            } else if (key == 'G' || key == 'g') {//złoty ruch
                 try_GM(g, act_x, act_y, length, &act_player);
-            } else if (entered_escape && entered_bracket) {//trzeci znak strzałki
-                try_arrows(g, &act_x, &act_y, length, ch);
-            } else if (ch == 'C' || ch == 'c') {//pomijamy ruch
+            } else if (key == 'C' || key == 'c') {//pomijamy ruch
                 next_player(g, &act_player);
                 print_player_during_game(g, act_player, length);
+            } else if (key >= KEY_PAGE_UP) {
+                uint32_t old_y = view.y;
+                try_jumps(g, &act_x, &act_y, length, key);
+                follow_cursor(g, length, act_x, act_y, view.y != old_y);
+            } else {
+                try_arrows(g, &act_x, &act_y, length, key);
+                follow_cursor(g, length, act_x, act_y, false);
             }
-            entered_escape = false;
-            entered_bracket = false;
         }
+        if (flash.active && latency_now() >= flash.deadline)
+            end_flash(g, act_x, act_y, length);
+        present();
     }
 }
@@ -9,11 +9,20 @@
 #define INTERACTIVE_H
 
 #include "gamma.h"
+#include "screen.h"
+#include "golden_worker.h"
+#include "trace.h"
+#include "latency.h"
 #include <termios.h>
 #include <inttypes.h>
 #include <time.h>
 #include <stdio.h>
 #include <sys/ioctl.h>
+#include <poll.h>
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
 
 /** @brief Obsługuje rozgrywkę w trybie interaktywnym
  * Wyświetla prostokątną plaszę początkowo wypełnioną przez '.'.
@@ -25,11 +34,15 @@
  * lub nic, jeśli zwróci @p false
  * Plansza może byc modyfikowana w następujący sposób:
  * – strzałkami zmienia się wybrane pole (odpowiedno góra/dól/prawo/lewo),
+ * – klawiszami Page Up i Page Down przeskakuje się o stronę w górę/dół,
+ * – klawiszami Home i End przeskakuje się na początek/koniec wiersza,
  * – spacją wykonuje się ruchu,
  * – klawiszem 'G' wykonuje się złoty ruch (o ile jest możliwy),
  * – klawiszem 'C' rezygnuje się z ruchu (o ile jest możliwy),
  * – kombinacją Ctr + D kończy się działanie gry.
  * Wydanie powyższych komend modyfikuje zmianę wyglądu planszy i napisu pod nią.
+ * Jeśli plansza nie mieści się w terminalu, to wyświetlany jest jej fragment,
+ * który podąża za wybranym polem i dopasowuje się do zmian rozmiaru terminala.
  * @param[in] g       – wskaźnik na strukturę gamma_t,
  */
 void interactive_mode(gamma_t *g);
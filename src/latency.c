@@ -0,0 +1,78 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "latency.h"
+#include <string.h>
+
+uint64_t latency_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+/* @brief Podaje numer przedziału, do którego należy wartość.
+ * @param[in] value   – wartość.
+ * @return Numer przedziału.
+ */
+static uint32_t latency_bucket(uint64_t value) {
+    if (value < LATENCY_SUB) return (uint32_t) value;
+    uint32_t shift = 63 - __builtin_clzll(value) - LATENCY_SUB_BITS;
+    return (shift + 1) * LATENCY_SUB + (uint32_t) (value >> shift) - LATENCY_SUB;
+}
+
+/* @brief Podaje największą wartość należącą do przedziału.
+ * @param[in] bucket  – numer przedziału.
+ * @return Górna granica przedziału.
+ */
+static uint64_t latency_bucket_upper(uint32_t bucket) {
+    if (bucket < LATENCY_SUB) return bucket;
+    uint32_t shift = bucket / LATENCY_SUB - 1;
+    uint64_t mantissa = bucket % LATENCY_SUB + LATENCY_SUB;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void latency_record(latency_t *latency, char command, uint64_t ns) {
+    const char *pos = memchr(LATENCY_COMMANDS, command, LATENCY_COMMANDS_COUNT);
+    if (command == '\0' || pos == NULL) return;
+    latency_histogram_t *hist = &latency->hist[pos - LATENCY_COMMANDS];
+    hist->count++;
+    hist->buckets[latency_bucket(ns)]++;
+    if (ns > hist->max) hist->max = ns;
+}
+
+/* @brief Podaje kwantyl histogramu.
+ * @param[in] hist     – histogram, w którym jest przynajmniej jeden pomiar,
+ * @param[in] per_10000 – rząd kwantyla w dziesięciotysięcznych częściach.
+ * @return Górna granica przedziału zawierającego kwantyl,
+ * nie większa niż największy pomiar.
+ */
+static uint64_t latency_quantile(const latency_histogram_t *hist,
+                                 uint64_t per_10000) {
+    uint64_t rank = (hist->count * per_10000 + 9999) / 10000;
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            uint64_t upper = latency_bucket_upper(b);
+            return upper < hist->max ? upper : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+void latency_print(const latency_t *latency, FILE *out) {
+    fprintf(out, "latency[ns] count p50 p99 p99.9 max\n");
+    for (size_t i = 0; i < LATENCY_COMMANDS_COUNT; i++) {
+        const latency_histogram_t *hist = &latency->hist[i];
+        if (hist->count == 0) continue;
+        fprintf(out, "%c %lu %lu %lu %lu %lu\n", LATENCY_COMMANDS[i],
+                hist->count, latency_quantile(hist, 5000),
+                latency_quantile(hist, 9900), latency_quantile(hist, 9990),
+                hist->max);
+    }
+}
@@ -0,0 +1,75 @@
+/** @file
+ * Interfejs histogramów czasu wykonania poleceń trybu wsadowego
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "gamma.h"
+#include <time.h>
+
+/** Liczba bitów mantysy w podziale log-liniowym – każda potęga dwójki
+ * dzielona jest na 2^LATENCY_SUB_BITS równych przedziałów.
+ */
+#define LATENCY_SUB_BITS 4
+
+/** Liczba przedziałów w jednej potędze dwójki.
+ */
+#define LATENCY_SUB (1 << LATENCY_SUB_BITS)
+
+/** Liczba przedziałów histogramu, wystarczająca dla wszystkich wartości
+ * typu uint64_t.
+ */
+#define LATENCY_BUCKETS ((64 - LATENCY_SUB_BITS + 1) * LATENCY_SUB)
+
+/** Litery poleceń, dla których mierzony jest czas wykonania.
+ */
+#define LATENCY_COMMANDS "mgbfqpPr"
+
+/** Liczba poleceń, dla których mierzony jest czas wykonania.
+ */
+#define LATENCY_COMMANDS_COUNT (sizeof(LATENCY_COMMANDS) - 1)
+
+/** @brief Histogram czasów wykonania jednego polecenia.
+ * Czasy (w nanosekundach) przypisywane są do przedziałów log-liniowych,
+ * więc błąd względny odczytanego kwantyla nie przekracza 1/LATENCY_SUB.
+ */
+struct latency_histogram {
+    uint64_t count; ///< liczba pomiarów
+    uint64_t max; ///< największy zmierzony czas
+    uint64_t buckets[LATENCY_BUCKETS]; ///< liczba pomiarów w przedziałach
+};
+typedef struct latency_histogram latency_histogram_t;
+
+/** @brief Histogramy czasów wykonania wszystkich mierzonych poleceń.
+ */
+struct latency {
+    latency_histogram_t hist[LATENCY_COMMANDS_COUNT]; ///< histogramy poleceń
+};
+typedef struct latency latency_t;
+
+/** @brief Podaje bieżący czas zegara monotonicznego.
+ * @return Czas w nanosekundach.
+ */
+uint64_t latency_now(void);
+
+/** @brief Zapisuje pomiar czasu wykonania polecenia.
+ * Nic nie robi, jeśli @p command nie jest jednym z @ref LATENCY_COMMANDS.
+ * @param[in,out] latency – histogramy poleceń,
+ * @param[in] command     – litera polecenia,
+ * @param[in] ns          – czas wykonania w nanosekundach.
+ */
+void latency_record(latency_t *latency, char command, uint64_t ns);
+
+/** @brief Wypisuje podsumowanie histogramów.
+ * Dla każdego polecenia, które wykonano przynajmniej raz, wypisuje liczbę
+ * pomiarów, kwantyle p50, p99, p99.9 oraz czas maksymalny (w nanosekundach).
+ * @param[in] latency – histogramy poleceń,
+ * @param[in] out     – strumień, do którego wypisywane jest podsumowanie.
+ */
+void latency_print(const latency_t *latency, FILE *out);
+
+#endif /* LATENCY_H */
@@ -0,0 +1,54 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "parse.h"
+
+/* @brief Sprawdza, czy znak jest białym znakiem (jak isspace w locale C).
+ * @param[in] letter       – znak do analizy
+ * @return @p true jeśli znak to biały znak, a @p false w przeciwnym razie.
+ */
+static bool is_space(char letter){
+  return letter == ' ' || ('\t' <= letter && letter <= '\r');
+}
+
+/* @brief Sprawdza, czy znak jest cyfrą.
+ * @param[in] letter       – znak do analizy
+ * @return @p true jeśli znak to cyfra, a @p false w przeciwnym razie.
+ */
+static bool is_digit(char letter){
+  return '0' <= letter && letter <= '9';
+}
+
+bool only_spaces(const char* buffer, uint64_t index){
+  for(uint64_t i = 0; i < index; i++){
+    if(!is_space(buffer[i]))
+      return false;
+  }
+  return true;
+}
+
+int32_t parse_arguments(const char* buffer, uint64_t length, uint32_t* argv){
+  //litera polecenia musi być oddzielona od argumentów
+  if(length > 1 && !is_space(buffer[1])) return -1;
+
+  int32_t argc = 0;
+  uint64_t i = 1;
+  while(i < length){
+    if(is_space(buffer[i])){
+      i++;
+      continue;
+    }
+    if(!is_digit(buffer[i]) || argc == COMMAND_ARGS_MAX) return -1;
+    uint64_t arg = 0;
+    for(; i < length && is_digit(buffer[i]); i++){
+      arg = arg * 10 + (uint64_t)(buffer[i] - '0');
+      if(arg > UINT32_MAX) return -1;
+    }
+    argv[argc++] = (uint32_t)arg;
+  }
+  return argc;
+}
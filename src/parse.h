@@ -0,0 +1,41 @@
+/** @file
+ * Interfejs parsera linii poleceń trybu wsadowego
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef PARSE_H
+#define PARSE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Największa liczba argumentów polecenia.
+ */
+#define COMMAND_ARGS_MAX 5
+
+/** @brief Sprawdza, czy słowo składa się z samych białych znaków
+ * @param[in] buffer       – tablica znaków, którą sprawdzamy
+ * @param[in] index        – wypełniona część słowa
+ * @return @p true jeśli słowo składa się z samych białych znaków,
+ * a @p false w przeciwnym razie.
+ */
+bool only_spaces(const char *buffer, uint64_t index);
+
+/** @brief Wczytuje argumenty polecenia w jednym przejściu po linii.
+ * Pierwszy znak linii to litera polecenia, po której musi wystąpić biały
+ * znak. Dalej mogą wystąpić tylko białe znaki i liczby dziesiętne
+ * mieszczące się w uint32_t. Linia nie jest modyfikowana i może zawierać
+ * znaki '\0', które traktowane są jako niepoprawne.
+ * @param[in] buffer       – linia polecenia bez znaku końca linii,
+ * @param[in] length       – długość linii, co najmniej 1,
+ * @param[out] argv        – tablica na co najmniej @ref COMMAND_ARGS_MAX
+ *                           argumentów.
+ * @return Liczba wczytanych argumentów lub -1, jeśli linia zawiera
+ * niedozwolony znak, liczbę spoza uint32_t lub więcej niż
+ * @ref COMMAND_ARGS_MAX argumentów.
+ */
+int32_t parse_arguments(const char *buffer, uint64_t length, uint32_t *argv);
+
+#endif /* PARSE_H */
@@ -0,0 +1,191 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "screen.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** Najdłuższy ciąg niezmienionych komórek, który opłaca się wysłać ponownie
+ * zamiast przesuwać kursor.
+ */
+#define SCREEN_GAP 6
+
+/** Sekwencje ustawiające atrybuty, w kolejności z @ref screen_attr.
+ */
+static const char *const attr_sequence[] = {
+        "\033[0m", "\033[0;7m", "\033[0;41;37m", "\033[0;42;37m", "\033[0;1m"
+};
+
+/* @brief Wypełnia bufor komórek spacjami.
+ * @param[out] cells – bufor,
+ * @param[in] count  – liczba komórek.
+ */
+static void fill_blank(screen_cell_t *cells, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        cells[i].ch = ' ';
+        cells[i].attr = SCREEN_NORMAL;
+    }
+}
+
+bool screen_init(screen_t *screen, uint32_t cols, uint32_t rows) {
+    size_t count = (size_t) cols * rows;
+    screen->cols = cols;
+    screen->rows = rows;
+    screen->front = malloc(count * sizeof(screen_cell_t));
+    screen->back = malloc(count * sizeof(screen_cell_t));
+    screen->out_cap = 4096;
+    screen->out = malloc(screen->out_cap);
+    screen->out_len = 0;
+    screen->clear = true;
+    if (screen->front == NULL || screen->back == NULL || screen->out == NULL) {
+        screen_free(screen);
+        return false;
+    }
+    fill_blank(screen->front, count);
+    fill_blank(screen->back, count);
+    return true;
+}
+
+void screen_free(screen_t *screen) {
+    free(screen->front);
+    free(screen->back);
+    free(screen->out);
+    screen->front = NULL;
+    screen->back = NULL;
+    screen->out = NULL;
+}
+
+void screen_put(screen_t *screen, uint32_t col, uint32_t row,
+                const char *s, size_t len, uint8_t attr) {
+    if (row >= screen->rows || col >= screen->cols) return;
+    if (len > screen->cols - col) len = screen->cols - col;
+    screen_cell_t *cell = screen->back + (size_t) row * screen->cols + col;
+    for (size_t i = 0; i < len; i++) {
+        cell[i].ch = s[i];
+        cell[i].attr = attr;
+    }
+}
+
+uint32_t screen_print(screen_t *screen, uint32_t col, uint32_t row,
+                      uint8_t attr, const char *format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t) len >= sizeof(text)) len = sizeof(text) - 1;
+    screen_put(screen, col, row, text, len, attr);
+    return (uint32_t) len;
+}
+
+void screen_clear_row(screen_t *screen, uint32_t col, uint32_t row) {
+    if (row >= screen->rows || col >= screen->cols) return;
+    fill_blank(screen->back + (size_t) row * screen->cols + col,
+               screen->cols - col);
+}
+
+/* @brief Dopisuje bajty do bufora wyjściowego, w razie potrzeby go powiększając.
+ * @param[in,out] screen – ekran,
+ * @param[in] s          – dopisywane bajty,
+ * @param[in] len        – liczba bajtów.
+ * @return Wartość @p true, jeśli udało się zaalokować pamięć,
+ * a @p false w przeciwnym razie.
+ */
+static bool out_append(screen_t *screen, const char *s, size_t len) {
+    if (screen->out_len + len > screen->out_cap) {
+        size_t cap = screen->out_cap;
+        while (screen->out_len + len > cap) cap *= 2;
+        char *out = realloc(screen->out, cap);
+        if (out == NULL) return false;
+        screen->out = out;
+        screen->out_cap = cap;
+    }
+    memcpy(screen->out + screen->out_len, s, len);
+    screen->out_len += len;
+    return true;
+}
+
+/* @brief Wysyła cały bufor wyjściowy do terminala.
+ * @param[in,out] screen – ekran.
+ * @return Wartość @p true, jeśli zapis się powiódł,
+ * a @p false w przeciwnym razie.
+ */
+static bool out_write(screen_t *screen) {
+    size_t done = 0;
+    fflush(stdout);
+    while (done < screen->out_len) {
+        ssize_t n = write(STDOUT_FILENO, screen->out + done,
+                          screen->out_len - done);
+        if (n < 0) return false;
+        done += (size_t) n;
+    }
+    screen->out_len = 0;
+    return true;
+}
+
+/* @brief Sprawdza, czy komórka różni się w obu buforach.
+ * @param[in] screen – ekran,
+ * @param[in] i      – indeks komórki.
+ * @return Wartość @p true, jeśli komórka wymaga odświeżenia.
+ */
+static bool dirty(const screen_t *screen, size_t i) {
+    return screen->front[i].ch != screen->back[i].ch
+           || screen->front[i].attr != screen->back[i].attr;
+}
+
+bool screen_flush(screen_t *screen) {
+    bool ok = true;
+    uint8_t attr = SCREEN_NORMAL;
+    if (screen->clear) {
+        ok = ok && out_append(screen, "\033[0m\033[1;1H\033[2J", 14);
+        fill_blank(screen->front, (size_t) screen->cols * screen->rows);
+        screen->clear = false;
+    }
+    for (uint32_t row = 0; row < screen->rows && ok; row++) {
+        size_t base = (size_t) row * screen->cols;
+        uint32_t col = 0;
+        while (col < screen->cols) {
+            if (!dirty(screen, base + col)) {
+                col++;
+                continue;
+            }
+            uint32_t end = col + 1, last = col;
+            while (end < screen->cols && end - last <= SCREEN_GAP) {
+                if (dirty(screen, base + end)) last = end;
+                end++;
+            }
+            char move[32];
+            int len = snprintf(move, sizeof(move), "\033[%u;%uH",
+                               row + 1, col + 1);
+            ok = ok && out_append(screen, move, len);
+            for (uint32_t c = col; c <= last && ok; c++) {
+                screen_cell_t *cell = &screen->back[base + c];
+                if (cell->attr != attr) {
+                    attr = cell->attr;
+                    ok = out_append(screen, attr_sequence[attr],
+                                    strlen(attr_sequence[attr]));
+                }
+                ok = ok && out_append(screen, &cell->ch, 1);
+            }
+            col = last + 1;
+        }
+    }
+    if (attr != SCREEN_NORMAL) ok = ok && out_append(screen, "\033[0m", 4);
+    if (!ok) {
+        screen->out_len = 0;
+        return false;
+    }
+    memcpy(screen->front, screen->back,
+           (size_t) screen->cols * screen->rows * sizeof(screen_cell_t));
+    return out_write(screen);
+}
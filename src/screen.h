@@ -0,0 +1,109 @@
+/** @file
+ * Interfejs podwójnie buforowanego ekranu terminala
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/** @brief Atrybuty wyświetlania znaku.
+ */
+enum screen_attr {
+    SCREEN_NORMAL = 0, ///< zwykły tekst
+    SCREEN_REVERSED, ///< zamienione kolory tła i czcionki
+    SCREEN_RED, ///< białe znaki na czerwonym tle
+    SCREEN_GREEN, ///< białe znaki na zielonym tle
+    SCREEN_BOLD ///< pogrubiony tekst
+};
+
+/** @brief Jedna komórka ekranu.
+ */
+struct screen_cell {
+    char ch; ///< wyświetlany znak
+    uint8_t attr; ///< atrybut wyświetlania, jedna z wartości @ref screen_attr
+};
+typedef struct screen_cell screen_cell_t;
+
+/** @brief Podwójnie buforowany ekran.
+ * Rysowanie odbywa się w buforze @p back. Funkcja @ref screen_flush
+ * porównuje go z buforem @p front (tym, co jest na terminalu), wypisuje
+ * jednym wywołaniem write() tylko zmienione fragmenty wierszy
+ * i kopiuje @p back do @p front.
+ */
+struct screen {
+    uint32_t cols; ///< liczba kolumn ekranu
+    uint32_t rows; ///< liczba wierszy ekranu
+    screen_cell_t *front; ///< zawartość terminala
+    screen_cell_t *back; ///< zawartość rysowanej klatki
+    char *out; ///< bufor sekwencji wysyłanych do terminala
+    size_t out_len; ///< zapełniona część bufora @p out
+    size_t out_cap; ///< rozmiar bufora @p out
+    bool clear; ///< czy przed następną klatką wyczyścić terminal
+};
+typedef struct screen screen_t;
+
+/** @brief Tworzy ekran o zadanym rozmiarze.
+ * Oba bufory wypełniane są spacjami. Pierwsza klatka poprzedzona jest
+ * wyczyszczeniem terminala.
+ * @param[out] screen – inicjowany ekran,
+ * @param[in] cols    – liczba kolumn, liczba dodatnia,
+ * @param[in] rows    – liczba wierszy, liczba dodatnia.
+ * @return Wartość @p true, jeśli udało się zaalokować pamięć,
+ * a @p false w przeciwnym razie.
+ */
+bool screen_init(screen_t *screen, uint32_t cols, uint32_t rows);
+
+/** @brief Zwalnia pamięć zajmowaną przez ekran.
+ * @param[in,out] screen – ekran.
+ */
+void screen_free(screen_t *screen);
+
+/** @brief Zapisuje napis w buforze @p back.
+ * Znaki wychodzące poza ekran są pomijane.
+ * @param[in,out] screen – ekran,
+ * @param[in] col        – kolumna pierwszego znaku (od zera),
+ * @param[in] row        – wiersz (od zera),
+ * @param[in] s          – napis,
+ * @param[in] len        – długość napisu,
+ * @param[in] attr       – atrybut wyświetlania.
+ */
+void screen_put(screen_t *screen, uint32_t col, uint32_t row,
+                const char *s, size_t len, uint8_t attr);
+
+/** @brief Zapisuje sformatowany napis w buforze @p back.
+ * Działa jak printf, napis jest obcinany do szerokości ekranu.
+ * @param[in,out] screen – ekran,
+ * @param[in] col        – kolumna pierwszego znaku (od zera),
+ * @param[in] row        – wiersz (od zera),
+ * @param[in] attr       – atrybut wyświetlania,
+ * @param[in] format     – format jak w printf.
+ * @return Liczba kolumn zajętych przez napis.
+ */
+uint32_t screen_print(screen_t *screen, uint32_t col, uint32_t row,
+                      uint8_t attr, const char *format, ...);
+
+/** @brief Wypełnia spacjami fragment wiersza w buforze @p back.
+ * @param[in,out] screen – ekran,
+ * @param[in] col        – pierwsza czyszczona kolumna,
+ * @param[in] row        – wiersz.
+ */
+void screen_clear_row(screen_t *screen, uint32_t col, uint32_t row);
+
+/** @brief Wysyła do terminala różnice między buforami.
+ * Zmienione komórki łączone są w przedziały w obrębie wiersza, dla każdego
+ * przedziału wysyłane jest jedno przesunięcie kursora, a sekwencje zmiany
+ * atrybutu tylko tam, gdzie atrybut się zmienia. Cała klatka wysyłana jest
+ * jednym wywołaniem write().
+ * @param[in,out] screen – ekran.
+ * @return Wartość @p true, jeśli udało się wysłać klatkę,
+ * a @p false w przeciwnym razie.
+ */
+bool screen_flush(screen_t *screen);
+
+#endif /* SCREEN_H */
@@ -0,0 +1,65 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "snapshot.h"
+#include <string.h>
+
+bool snapshot_init(snapshot_t *s, const gamma_params_t *params) {
+    memset(s, 0, sizeof(snapshot_t));
+    if (params->width == 0 || params->height == 0) return false;
+    s->params = *params;
+    s->owners = calloc((uint64_t) params->width * params->height,
+                       sizeof(uint32_t));
+    return s->owners != NULL;
+}
+
+bool snapshot_set(snapshot_t *s, uint32_t x, uint32_t y, uint32_t player) {
+    uint32_t *owner = &s->owners[(uint64_t) y * s->params.width + x];
+    if (*owner != 0) {
+        if (s->golden_count == s->golden_cap) {
+            uint32_t cap = s->golden_cap == 0 ? 4 : 2 * s->golden_cap;
+            uint32_t *golden = realloc(s->golden, cap * sizeof(uint32_t));
+            if (golden == NULL) return false;
+            s->golden = golden;
+            s->golden_cap = cap;
+        }
+        s->golden[s->golden_count++] = player;
+    }
+    *owner = player;
+    return true;
+}
+
+gamma_t *snapshot_game(const snapshot_t *s) {
+    const gamma_params_t *params = &s->params;
+    //bez limitu obszarów pionki można stawiać w dowolnej kolejności
+    gamma_t *g = gamma_new(params->width, params->height, params->players,
+                           UINT32_MAX);
+    if (g == NULL) return NULL;
+    bool valid = true;
+    const uint32_t *owner = s->owners;
+    for (uint32_t y = 0; valid && y < params->height; y++)
+        for (uint32_t x = 0; valid && x < params->width; x++, owner++)
+            valid = *owner == 0 || gamma_move(g, *owner, x, y);
+    //gracz nie może wykonać dwóch złotych ruchów
+    valid = valid
+            && gamma_restore(g, params->areas, s->golden, s->golden_count)
+            && gamma_golden_players(g, NULL, 0) == s->golden_count;
+    if (!valid) {
+        gamma_delete(g);
+        return NULL;
+    }
+    return g;
+}
+
+void snapshot_free(snapshot_t *s) {
+    free(s->owners);
+    free(s->golden);
+    s->owners = NULL;
+    s->golden = NULL;
+    s->golden_count = 0;
+    s->golden_cap = 0;
+}
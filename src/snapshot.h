@@ -0,0 +1,59 @@
+/** @file
+ * Interfejs kopii planszy, z której można odtworzyć grę
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "gamma.h"
+
+/** @brief Kopia planszy: właściciele pól i gracze, którzy wykonali złoty
+ * ruch. Tyle wystarcza, by odtworzyć grę (@ref snapshot_game).
+ */
+struct snapshot {
+    gamma_params_t params; ///< parametry gry
+    uint32_t *owners; ///< owners[y * width + x] – gracz na polu (x, y) lub 0
+    uint32_t *golden; ///< gracze, którzy wykonali złoty ruch
+    uint32_t golden_count; ///< liczba graczy w @p golden
+    uint32_t golden_cap; ///< rozmiar tablicy @p golden
+};
+typedef struct snapshot snapshot_t;
+
+/** @brief Tworzy kopię pustej planszy gry o parametrach @p params.
+ * @param[out] s      – kopia planszy,
+ * @param[in] params  – parametry gry.
+ * @return Wartość @p true, jeśli utworzono kopię, a @p false, gdy plansza
+ * jest pusta lub nie udało się zaalokować pamięci.
+ */
+bool snapshot_init(snapshot_t *s, const gamma_params_t *params);
+
+/** @brief Stawia pionek gracza na polu kopii planszy.
+ * Postawienie pionka na zajętym polu to złoty ruch gracza @p player.
+ * @param[in,out] s   – kopia planszy,
+ * @param[in] x       – numer kolumny, mniejszy od szerokości planszy,
+ * @param[in] y       – numer wiersza, mniejszy od wysokości planszy,
+ * @param[in] player  – numer gracza.
+ * @return Wartość @p true, jeśli postawiono pionek, a @p false, gdy nie
+ * udało się zaalokować pamięci.
+ */
+bool snapshot_set(snapshot_t *s, uint32_t x, uint32_t y, uint32_t player);
+
+/** @brief Odtwarza grę z kopii planszy.
+ * Stawia pionki wierszami na nowej grze bez limitu obszarów, a na koniec
+ * ustawia limit z parametrów gry (@ref gamma_restore).
+ * @param[in] s       – kopia planszy.
+ * @return Gra lub NULL, jeśli któryś pionek jest niepoprawny, któryś gracz
+ * przekracza limit obszarów, złoty ruch gracza się powtarza lub nie udało
+ * się zaalokować pamięci.
+ */
+gamma_t *snapshot_game(const snapshot_t *s);
+
+/** @brief Zwalnia tablice kopii planszy.
+ * @param[in,out] s   – kopia planszy.
+ */
+void snapshot_free(snapshot_t *s);
+
+#endif /* SNAPSHOT_H */
@@ -0,0 +1,156 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "trace.h"
+#include "gamma_pool.h"
+#include "varint.h"
+#include <string.h>
+
+/** Plik, do którego zapisywany jest ślad, lub NULL.
+ */
+static FILE *trace_file = NULL;
+
+/** Chwila rozpoczęcia poprzedniego rekordu śladu (w nanosekundach).
+ */
+static uint64_t trace_last = 0;
+
+bool trace_open(const char *path) {
+    trace_file = fopen(path, "wb");
+    if (trace_file == NULL) return false;
+    setvbuf(trace_file, NULL, _IOFBF, TRACE_BUFFER);
+    fwrite(TRACE_MAGIC, 1, TRACE_MAGIC_LENGTH, trace_file);
+    trace_last = latency_now();
+    atexit(trace_close);
+    return true;
+}
+
+void trace_close(void) {
+    if (trace_file == NULL) return;
+    fclose(trace_file);
+    trace_file = NULL;
+}
+
+void trace_game(gamma_t *g) {
+    if (trace_file == NULL || g == NULL) return;
+    putc('N', trace_file);
+    varint_put(trace_file, g->width);
+    varint_put(trace_file, g->height);
+    varint_put(trace_file, g->players);
+    varint_put(trace_file, g->areas);
+    trace_last = latency_now();
+}
+
+/* @brief Zapisuje w śladzie wywołanie ruchu.
+ * @param[in] kind    – 'm' dla zwykłego, 'g' dla złotego ruchu,
+ * @param[in] result  – wynik wywołania,
+ * @param[in] start   – chwila rozpoczęcia wywołania,
+ * @param[in] end     – chwila zakończenia wywołania,
+ * @param[in] player  – numer gracza,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza.
+ */
+static void trace_call(char kind, bool result, uint64_t start, uint64_t end,
+                       uint32_t player, uint32_t x, uint32_t y) {
+    putc(result ? kind - 'a' + 'A' : kind, trace_file);
+    varint_put(trace_file, start - trace_last);
+    varint_put(trace_file, end - start);
+    varint_put(trace_file, player);
+    varint_put(trace_file, x);
+    varint_put(trace_file, y);
+    trace_last = start;
+}
+
+bool trace_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    if (trace_file == NULL) return gamma_move(g, player, x, y);
+    uint64_t start = latency_now();
+    bool result = gamma_move(g, player, x, y);
+    trace_call('m', result, start, latency_now(), player, x, y);
+    return result;
+}
+
+bool trace_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    if (trace_file == NULL) return gamma_golden_move(g, player, x, y);
+    uint64_t start = latency_now();
+    bool result = gamma_golden_move(g, player, x, y);
+    trace_call('g', result, start, latency_now(), player, x, y);
+    return result;
+}
+
+/* @brief Wypisuje podsumowanie odtworzenia śladu.
+ * @param[in] out        – strumień,
+ * @param[in] latency    – histogramy czasów wywołań przy odtworzeniu,
+ * @param[in] calls      – liczba wywołań,
+ * @param[in] mismatches – liczba wyników niezgodnych z zapisem,
+ * @param[in] recorded   – łączny czas wywołań w zapisie,
+ * @param[in] replayed   – łączny czas wywołań przy odtworzeniu.
+ */
+static void replay_report(FILE *out, const latency_t *latency, uint64_t calls,
+                          uint64_t mismatches, uint64_t recorded,
+                          uint64_t replayed) {
+    fprintf(out, "calls %lu mismatches %lu\n", calls, mismatches);
+    fprintf(out, "recorded[ns] %lu\n", recorded);
+    fprintf(out, "replayed[ns] %lu\n", replayed);
+    fprintf(out, "throughput[calls/s] %.0f\n",
+            replayed == 0 ? 0.0 : calls * 1e9 / (double) replayed);
+    latency_print(latency, out);
+}
+
+bool trace_replay(const char *path, FILE *out) {
+    FILE *in = fopen(path, "rb");
+    if (in == NULL) return false;
+    setvbuf(in, NULL, _IOFBF, TRACE_BUFFER);
+
+    static latency_t latency;
+    memset(&latency, 0, sizeof(latency));
+    //gry o tych samych wymiarach są przywracane zamiast tworzone od nowa
+    gamma_pool_t pool;
+    gamma_pool_init(&pool, 1);
+    char magic[TRACE_MAGIC_LENGTH];
+    gamma_t *g = NULL;
+    uint64_t calls = 0, mismatches = 0, recorded = 0, replayed = 0;
+    bool valid = fread(magic, 1, TRACE_MAGIC_LENGTH, in) == TRACE_MAGIC_LENGTH
+                 && memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_LENGTH) == 0;
+
+    int kind;
+    while (valid && (kind = getc(in)) != EOF) {
+        if (kind == 'N') {
+            uint32_t width, height, players, areas;
+            valid = varint_get32(in, &width) && varint_get32(in, &height)
+                    && varint_get32(in, &players) && varint_get32(in, &areas);
+            gamma_pool_put(&pool, g);
+            g = valid ? gamma_pool_get(&pool, width, height, players, areas)
+                      : NULL;
+            valid = (g != NULL);
+            continue;
+        }
+        uint64_t delay, duration;
+        uint32_t player, x, y;
+        bool golden = (kind == 'g' || kind == 'G');
+        valid = g != NULL && (golden || kind == 'm' || kind == 'M')
+                && varint_get(in, &delay) && varint_get(in, &duration)
+                && varint_get32(in, &player) && varint_get32(in, &x)
+                && varint_get32(in, &y);
+        if (!valid) break;
+
+        uint64_t start = latency_now();
+        bool result = golden ? gamma_golden_move(g, player, x, y)
+                             : gamma_move(g, player, x, y);
+        uint64_t time = latency_now() - start;
+        latency_record(&latency, golden ? 'g' : 'm', time);
+        calls++;
+        recorded += duration;
+        replayed += time;
+        if (result != (kind == 'M' || kind == 'G')) mismatches++;
+    }
+    fclose(in);
+    gamma_delete(g);
+    gamma_pool_clear(&pool);
+    if (!valid) return false;
+
+    replay_report(out, &latency, calls, mismatches, recorded, replayed);
+    return mismatches == 0;
+}
@@ -0,0 +1,73 @@
+/** @file
+ * Interfejs zapisu i odtwarzania śladu wywołań ruchów
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "gamma.h"
+#include "latency.h"
+
+/** Znaczniki na początku pliku ze śladem, ostatni bajt to wersja formatu.
+ */
+#define TRACE_MAGIC "GMTR\001"
+
+/** Długość znacznika @ref TRACE_MAGIC.
+ */
+#define TRACE_MAGIC_LENGTH 5
+
+/** Rozmiar bufora zapisu śladu.
+ */
+#define TRACE_BUFFER (1 << 20)
+
+/** @brief Rozpoczyna zapis śladu do pliku @p path.
+ * Plik zaczyna się znacznikiem @ref TRACE_MAGIC, po którym następują rekordy:
+ * – 'N' i parametry gry (szerokość, wysokość, liczba graczy, liczba obszarów),
+ * – 'm' / 'g' dla odrzuconego oraz 'M' / 'G' dla wykonanego zwykłego / złotego
+ *   ruchu, a po nich: czas od początku poprzedniego rekordu, czas wykonania
+ *   (oba w nanosekundach), numer gracza, x oraz y.
+ * Wszystkie liczby zapisywane są jako varint (po 7 bitów, od najmłodszych).
+ * Ślad jest zamykany przy zakończeniu programu.
+ * @param[in] path    – ścieżka do pliku.
+ * @return Wartość @p true, jeśli udało się otworzyć plik,
+ * a @p false w przeciwnym razie.
+ */
+bool trace_open(const char *path);
+
+/** @brief Kończy zapis śladu i zamyka plik.
+ * Nic nie robi, jeśli ślad nie jest zapisywany.
+ */
+void trace_close(void);
+
+/** @brief Zapisuje w śladzie parametry nowej gry.
+ * Nic nie robi, jeśli ślad nie jest zapisywany.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ */
+void trace_game(gamma_t *g);
+
+/** @brief Wykonuje @ref gamma_move i zapisuje wywołanie w śladzie.
+ * Parametry i wynik są takie same jak w @ref gamma_move.
+ */
+bool trace_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Wykonuje @ref gamma_golden_move i zapisuje wywołanie w śladzie.
+ * Parametry i wynik są takie same jak w @ref gamma_golden_move.
+ */
+bool trace_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Odtwarza ślad z pliku @p path z maksymalną szybkością.
+ * Wykonuje zapisane wywołania na nowej grze o zapisanych parametrach,
+ * sprawdza, czy dają zapisane wyniki, i wypisuje do @p out liczbę wywołań
+ * i niezgodnych wyników, łączny czas wywołań w zapisie i przy odtworzeniu,
+ * przepustowość oraz histogramy czasów wywołań.
+ * @param[in] path    – ścieżka do pliku,
+ * @param[in] out     – strumień, do którego wypisywane jest podsumowanie.
+ * @return Wartość @p true, jeśli ślad odtworzono i wszystkie wyniki są
+ * zgodne z zapisem, a @p false w przeciwnym razie.
+ */
+bool trace_replay(const char *path, FILE *out);
+
+#endif /* TRACE_H */
@@ -0,0 +1,34 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#include "varint.h"
+
+void varint_put(FILE *out, uint64_t value) {
+    while (value >= 0x80) {
+        putc((int) (value & 0x7f) | 0x80, out);
+        value >>= 7;
+    }
+    putc((int) value, out);
+}
+
+bool varint_get(FILE *in, uint64_t *value) {
+    *value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        int c = getc(in);
+        if (c == EOF) return false;
+        *value |= (uint64_t) (c & 0x7f) << shift;
+        if ((c & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool varint_get32(FILE *in, uint32_t *value) {
+    uint64_t v;
+    if (!varint_get(in, &v) || v > UINT32_MAX) return false;
+    *value = (uint32_t) v;
+    return true;
+}
@@ -0,0 +1,37 @@
+/** @file
+ * Interfejs zapisu liczb w formacie varint
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** @brief Zapisuje liczbę jako varint (po 7 bitów, od najmłodszych).
+ * @param[in] out     – strumień,
+ * @param[in] value   – liczba.
+ */
+void varint_put(FILE *out, uint64_t value);
+
+/** @brief Wczytuje liczbę zapisaną jako varint.
+ * @param[in] in      – strumień,
+ * @param[out] value  – liczba.
+ * @return Wartość @p true, jeśli wczytano całą liczbę,
+ * a @p false w przeciwnym razie.
+ */
+bool varint_get(FILE *in, uint64_t *value);
+
+/** @brief Wczytuje liczbę typu uint32_t zapisaną jako varint.
+ * @param[in] in      – strumień,
+ * @param[out] value  – liczba.
+ * @return Wartość @p true, jeśli wczytano liczbę mieszczącą się w uint32_t,
+ * a @p false w przeciwnym razie.
+ */
+bool varint_get32(FILE *in, uint32_t *value);
+
+#endif /* VARINT_H */
@@ -0,0 +1,390 @@
+/* @file
+ *
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+//open_memstream
+#define _POSIX_C_SOURCE 200809L
+
+#include "wal.h"
+#include "latency.h"
+#include "snapshot.h"
+#include "varint.h"
+#include <limits.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/** Początkowa wartość sumy kontrolnej grupy rekordów.
+ */
+#define WAL_HASH_SEED 0xcbf29ce484222325ULL
+
+/** @brief Rekord dziennika.
+ */
+typedef struct wal_record {
+    char kind; ///< 'N', 'M' lub 'G'
+    uint64_t line; ///< numer linii wejścia
+    uint32_t values[4]; ///< parametry gry dla 'N', a gracz, x i y dla ruchu
+} wal_record_t;
+
+/** @brief Grupa rekordów wczytanych, ale jeszcze niezamkniętych.
+ */
+typedef struct wal_group {
+    wal_record_t *records; ///< rekordy grupy
+    uint64_t count; ///< liczba rekordów w @p records
+    uint64_t cap; ///< rozmiar tablicy @p records
+    uint64_t hash; ///< suma kontrolna wartości rekordów
+} wal_group_t;
+
+/** Plik z dziennikiem lub NULL, jeśli dziennik nie jest włączony.
+ */
+static const char *wal_path = NULL;
+
+/** Otwarty dziennik lub NULL.
+ */
+static FILE *wal_file = NULL;
+
+/** Co ile rekordów utrwalać dziennik (0 – bez limitu rekordów).
+ */
+static uint64_t wal_records = 0;
+
+/** Co ile nanosekund utrwalać dziennik (0 – bez limitu czasu).
+ */
+static uint64_t wal_ns = 0;
+
+/** Liczba rekordów w bieżącej grupie.
+ */
+static uint64_t wal_count = 0;
+
+/** Suma kontrolna bieżącej grupy.
+ */
+static uint64_t wal_hash_value = WAL_HASH_SEED;
+
+/** Numer linii wejścia z ostatniego rekordu.
+ */
+static uint64_t wal_line = 0;
+
+/** Chwila ostatniego utrwalenia dziennika (w nanosekundach).
+ */
+static uint64_t wal_last = 0;
+
+/** Czy zapis dziennika się nie powiódł – wyniki nie mogą być już wypisane.
+ */
+static bool wal_broken = false;
+
+/** Wyniki poleceń czekające na utrwalenie dziennika (@ref wal_output)
+ * lub NULL, jeśli dziennik nie jest zapisywany.
+ */
+static FILE *wal_out = NULL;
+
+/** Bufor strumienia @ref wal_out.
+ */
+static char *wal_out_data = NULL;
+
+/** Liczba bajtów w buforze @ref wal_out_data po ostatnim fflush.
+ */
+static size_t wal_out_size = 0;
+
+/* @brief Dołącza wartość do sumy kontrolnej.
+ * @param[in] hash    – suma kontrolna,
+ * @param[in] value   – wartość.
+ * @return Nowa suma kontrolna.
+ */
+static uint64_t wal_hash(uint64_t hash, uint64_t value) {
+    return (hash ^ value) * 0x100000001b3ULL;
+}
+
+/* @brief Zapisuje wartość rekordu i dołącza ją do sumy kontrolnej grupy.
+ * @param[in] value   – wartość.
+ */
+static void wal_put(uint64_t value) {
+    varint_put(wal_file, value);
+    wal_hash_value = wal_hash(wal_hash_value, value);
+}
+
+/* @brief Zamyka dziennik po błędzie zapisu.
+ * @return Wartość @p false.
+ */
+static bool wal_fail(void) {
+    fclose(wal_file);
+    wal_file = NULL;
+    wal_count = 0;
+    wal_broken = true;
+    return false;
+}
+
+/* @brief Zamyka bieżącą grupę rekordów i utrwala dziennik na dysku.
+ * @return Wartość @p true, jeśli utrwalenie się powiodło,
+ * a @p false w przeciwnym razie.
+ */
+static bool wal_commit(void) {
+    putc('C', wal_file);
+    varint_put(wal_file, wal_count);
+    varint_put(wal_file, wal_hash_value);
+    wal_count = 0;
+    wal_hash_value = WAL_HASH_SEED;
+    if (wal_ns != 0) wal_last = latency_now();
+    return fflush(wal_file) == 0 && fdatasync(fileno(wal_file)) == 0;
+}
+
+/* @brief Przepisuje na standardowe wyjście wyniki czekające w @ref wal_out,
+ * a jeśli dziennik nie został utrwalony, porzuca je.
+ */
+static void wal_emit(void) {
+    if (wal_out == NULL || fflush(wal_out) != 0) return;
+    if (!wal_broken && wal_count == 0 && wal_out_size > 0) {
+        fwrite(wal_out_data, 1, wal_out_size, stdout);
+        fflush(stdout);
+    }
+    rewind(wal_out);
+}
+
+/* @brief Zamyka bieżącą grupę rekordów, jeśli jest niepusta, i wypisuje
+ * wyniki czekające na jej utrwalenie.
+ * @return Wartość @p true, jeśli grupa jest pusta lub jej utrwalenie się
+ * powiodło, a @p false w przeciwnym razie – dziennik jest wtedy zamykany,
+ * a wyniki porzucane.
+ */
+static bool wal_sync(void) {
+    bool synced = !wal_broken
+                  && (wal_count == 0 || wal_commit() || wal_fail());
+    wal_emit();
+    return synced;
+}
+
+/* @brief Sprawdza, czy od poprzedniego utrwalenia minął czas podany
+ * w @ref wal_start.
+ * @return Wartość @p true, jeśli grupa jest niepusta i minął czas,
+ * a @p false w przeciwnym razie.
+ */
+static bool wal_late(void) {
+    return wal_count > 0 && wal_ns != 0 && latency_now() - wal_last >= wal_ns;
+}
+
+FILE *wal_output(void) {
+    //bez czekających ruchów i wyników nie ma na co czekać
+    if (wal_out == NULL || (wal_count == 0 && ftell(wal_out) == 0))
+        return stdout;
+    //wyniki nie mogą czekać w pamięci bez końca
+    if (ftell(wal_out) >= WAL_BUFFER && !wal_sync()) {
+        fprintf(stderr, "ERROR %lu\n", wal_line);
+        exit(1);
+    }
+    return wal_out;
+}
+
+int wal_timeout(void) {
+    if (wal_out == NULL || (wal_count == 0 && ftell(wal_out) == 0)) return -1;
+    if (wal_count == 0 || wal_ns == 0) return 0;
+    uint64_t spent = latency_now() - wal_last;
+    if (spent >= wal_ns) return 0;
+    uint64_t ms = (wal_ns - spent + 999999) / 1000000;
+    return ms > INT_MAX ? INT_MAX : (int) ms;
+}
+
+bool wal_flush(void) {
+    return wal_out == NULL ? !wal_broken : wal_sync();
+}
+
+void wal_start(const char *path, uint64_t records, uint64_t ns) {
+    wal_path = path;
+    wal_records = (records == 0 && ns == 0) ? WAL_RECORDS_DEFAULT : records;
+    wal_ns = ns;
+}
+
+/* @brief Wczytuje rekord o podanym rodzaju i dołącza go do sumy kontrolnej.
+ * @param[in] in        – strumień,
+ * @param[in] kind      – rodzaj rekordu,
+ * @param[in,out] line  – numer linii z poprzedniego rekordu,
+ * @param[in,out] hash  – suma kontrolna grupy,
+ * @param[out] record   – rekord.
+ * @return Wartość @p true, jeśli wczytano cały rekord,
+ * a @p false w przeciwnym razie.
+ */
+static bool record_get(FILE *in, int kind, uint64_t *line, uint64_t *hash,
+                       wal_record_t *record) {
+    uint64_t number;
+    uint32_t count = (kind == 'N') ? 4 : 3;
+    if ((kind != 'N' && kind != 'M' && kind != 'G')
+        || !varint_get(in, &number))
+        return false;
+    *hash = wal_hash(wal_hash(*hash, (uint64_t) kind), number);
+    //rekord ruchu zawiera przyrost numeru linii
+    *line = (kind == 'N') ? number : *line + number;
+    record->kind = (char) kind;
+    record->line = *line;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!varint_get32(in, &record->values[i])) return false;
+        *hash = wal_hash(*hash, record->values[i]);
+    }
+    return true;
+}
+
+/* @brief Dopisuje rekord do grupy.
+ * @param[in,out] group – grupa,
+ * @param[in] record    – rekord.
+ * @return Wartość @p true, jeśli dopisano rekord, a @p false, gdy nie udało
+ * się zaalokować pamięci.
+ */
+static bool group_push(wal_group_t *group, const wal_record_t *record) {
+    if (group->count == group->cap) {
+        uint64_t cap = group->cap == 0 ? 1024 : 2 * group->cap;
+        wal_record_t *records = realloc(group->records,
+                                        cap * sizeof(wal_record_t));
+        if (records == NULL) return false;
+        group->records = records;
+        group->cap = cap;
+    }
+    group->records[group->count++] = *record;
+    return true;
+}
+
+/* @brief Wykonuje rekordy zamkniętej grupy na planszy odtwarzanej gry.
+ * Sprawdza tylko, czy ruch mieści się na planszy i trafia na pole wolne
+ * (zwykły ruch) lub zajęte przez innego gracza (złoty ruch); limit obszarów
+ * sprawdza na koniec @ref gamma_restore.
+ * @param[in] group      – grupa,
+ * @param[in,out] replay – stan odtwarzanej gry.
+ * @return Wartość @p true, jeśli wykonano wszystkie rekordy, a @p false,
+ * gdy ruch jest niedozwolony, gra jest tworzona ponownie lub nie udało
+ * się zaalokować pamięci.
+ */
+static bool group_apply(const wal_group_t *group, snapshot_t *replay) {
+    gamma_params_t *params = &replay->params;
+    for (uint64_t i = 0; i < group->count; i++) {
+        const wal_record_t *r = &group->records[i];
+        if (r->kind == 'N') {
+            gamma_params_t created = {r->values[0], r->values[1],
+                                      r->values[2], r->values[3]};
+            if (replay->owners != NULL || !snapshot_init(replay, &created))
+                return false;
+            continue;
+        }
+        uint32_t player = r->values[0], x = r->values[1], y = r->values[2];
+        if (replay->owners == NULL || player < 1 || player > params->players
+            || x >= params->width || y >= params->height)
+            return false;
+        uint32_t owner = replay->owners[(uint64_t) y * params->width + x];
+        if ((owner != 0) != (r->kind == 'G') || owner == player
+            || !snapshot_set(replay, x, y, player))
+            return false;
+    }
+    return true;
+}
+
+bool wal_read(FILE *in, gamma_t **g, uint64_t *line, uint64_t *length) {
+    wal_group_t group = {NULL, 0, 0, WAL_HASH_SEED};
+    snapshot_t replay = {{0, 0, 0, 0}, NULL, NULL, 0, 0};
+    uint64_t current = 0;
+    bool valid = true;
+    int kind;
+    *g = NULL;
+    *line = 0;
+    *length = (uint64_t) ftell(in);
+    //niezamknięta lub uszkodzona grupa kończy dziennik
+    while (valid && (kind = getc(in)) != EOF) {
+        wal_record_t record;
+        if (kind != 'C') {
+            if (!record_get(in, kind, &current, &group.hash, &record)) break;
+            valid = group_push(&group, &record);
+            continue;
+        }
+        uint64_t count, hash;
+        if (!varint_get(in, &count) || !varint_get(in, &hash)
+            || count != group.count || hash != group.hash)
+            break;
+        valid = group_apply(&group, &replay);
+        if (group.count > 0) *line = group.records[group.count - 1].line;
+        group.count = 0;
+        group.hash = WAL_HASH_SEED;
+        *length = (uint64_t) ftell(in);
+    }
+    free(group.records);
+    if (valid && replay.owners != NULL) {
+        *g = snapshot_game(&replay);
+        valid = (*g != NULL);
+    }
+    snapshot_free(&replay);
+    return valid;
+}
+
+bool wal_recover(gamma_t **g, uint64_t *line) {
+    *g = NULL;
+    *line = 0;
+    wal_file = fopen(wal_path, "r+b");
+    if (wal_file == NULL) wal_file = fopen(wal_path, "w+b");
+    if (wal_file == NULL) return false;
+    setvbuf(wal_file, NULL, _IOFBF, WAL_BUFFER);
+
+    char magic[WAL_MAGIC_LENGTH];
+    size_t read = fread(magic, 1, WAL_MAGIC_LENGTH, wal_file);
+    uint64_t length = WAL_MAGIC_LENGTH;
+    bool valid;
+    if (read < WAL_MAGIC_LENGTH && memcmp(magic, WAL_MAGIC, read) == 0) {
+        //dziennik jest nowy lub awaria przerwała zapis znacznika
+        valid = fseek(wal_file, 0, SEEK_SET) == 0
+                && fwrite(WAL_MAGIC, 1, WAL_MAGIC_LENGTH, wal_file)
+                   == WAL_MAGIC_LENGTH;
+    } else {
+        valid = read == WAL_MAGIC_LENGTH
+                && memcmp(magic, WAL_MAGIC, WAL_MAGIC_LENGTH) == 0
+                && wal_read(wal_file, g, line, &length);
+    }
+    //kolejne rekordy są dopisywane za ostatnią zamkniętą grupą
+    valid = valid && fseek(wal_file, (long) length, SEEK_SET) == 0
+            && ftruncate(fileno(wal_file), (off_t) length) == 0;
+    wal_out = valid ? open_memstream(&wal_out_data, &wal_out_size) : NULL;
+    if (wal_out == NULL) {
+        gamma_delete(*g);
+        *g = NULL;
+        return wal_fail();
+    }
+    wal_line = *line;
+    wal_last = latency_now();
+    atexit(wal_close);
+    return true;
+}
+
+bool wal_game(gamma_t *g, uint64_t line) {
+    if (wal_file == NULL || g == NULL) return !wal_broken;
+    putc('N', wal_file);
+    wal_hash_value = wal_hash(wal_hash_value, 'N');
+    wal_put(line);
+    wal_put(g->width);
+    wal_put(g->height);
+    wal_put(g->players);
+    wal_put(g->areas);
+    wal_line = line;
+    wal_count++;
+    return wal_sync();
+}
+
+bool wal_move(bool golden, uint32_t player, uint32_t x, uint32_t y,
+              uint64_t line) {
+    if (wal_file == NULL) return !wal_broken;
+    char kind = golden ? 'G' : 'M';
+    putc(kind, wal_file);
+    wal_hash_value = wal_hash(wal_hash_value, (uint64_t) kind);
+    wal_put(line - wal_line);
+    wal_put(player);
+    wal_put(x);
+    wal_put(y);
+    wal_line = line;
+    wal_count++;
+    bool due = (wal_records != 0 && wal_count >= wal_records) || wal_late();
+    return !due || wal_sync();
+}
+
+void wal_close(void) {
+    if (wal_out == NULL) return;
+    wal_flush();
+    fclose(wal_out);
+    free(wal_out_data);
+    wal_out = NULL;
+    wal_out_data = NULL;
+    if (wal_file == NULL) return;
+    fclose(wal_file);
+    wal_file = NULL;
+}
@@ -0,0 +1,138 @@
+/** @file
+ * Interfejs dziennika ruchów zapisywanego przed potwierdzeniem (WAL)
+ * @author Grzegorz Gruza <gg417923@mimuw.edu.pl>
+ * @copyright Grzegorz Gruza
+ * @date 19.10.2026
+ */
+
+#ifndef WAL_H
+#define WAL_H
+
+#include "gamma.h"
+
+/** Znaczniki na początku pliku z dziennikiem, ostatni bajt to wersja formatu.
+ */
+#define WAL_MAGIC "GMWL\001"
+
+/** Długość znacznika @ref WAL_MAGIC.
+ */
+#define WAL_MAGIC_LENGTH 5
+
+/** Co ile rekordów dziennik jest utrwalany na dysku, jeśli nie podano ani
+ * liczby rekordów, ani czasu.
+ */
+#define WAL_RECORDS_DEFAULT 1000
+
+/** Rozmiar bufora zapisu i odczytu dziennika.
+ */
+#define WAL_BUFFER (1 << 16)
+
+/** @brief Włącza zapisywanie wykonanych ruchów w dzienniku @p path.
+ * Plik zaczyna się znacznikiem @ref WAL_MAGIC, po którym następują rekordy:
+ * – 'N', numer linii wejścia i parametry gry (szerokość, wysokość, liczba
+ *   graczy, liczba obszarów),
+ * – 'M' / 'G' dla wykonanego zwykłego / złotego ruchu, a po nich: przyrost
+ *   numeru linii wejścia od poprzedniego rekordu, numer gracza, x oraz y,
+ * – 'C' zamykający grupę rekordów od poprzedniego 'C', a po nim liczba
+ *   rekordów grupy i suma kontrolna ich wartości.
+ * Wszystkie liczby zapisywane są jako varint. Grupa jest zamykana
+ * i utrwalana na dysku (fdatasync) co @p records rekordów, gdy od
+ * poprzedniego utrwalenia minęło @p ns nanosekund, przed oczekiwaniem na
+ * wejście (@ref wal_flush) oraz na koniec programu. Wyniki poleceń czekają
+ * w strumieniu @ref wal_output i są wypisywane dopiero po utrwaleniu grupy,
+ * więc ruchy z grupy niezamkniętej w chwili awarii mogą zostać utracone,
+ * ale ich wyniki nie zostały jeszcze wypisane.
+ * @param[in] path    – ścieżka do pliku,
+ * @param[in] records – co ile rekordów utrwalać dziennik lub 0,
+ * @param[in] ns      – co ile nanosekund utrwalać dziennik lub 0;
+ *                      jeśli @p records i @p ns są równe 0, dziennik
+ *                      utrwalany jest co @ref WAL_RECORDS_DEFAULT rekordów.
+ */
+void wal_start(const char *path, uint64_t records, uint64_t ns);
+
+/** @brief Otwiera dziennik wskazany w @ref wal_start i odtwarza z niego grę.
+ * Plik, którego nie ma, jest tworzony. Odtwarzane są wszystkie zamknięte
+ * grupy rekordów; niezamknięty lub uszkodzony koniec pliku jest obcinany
+ * i kolejne rekordy dopisywane są za ostatnią zamkniętą grupą.
+ * @param[out] g      – odtworzona gra lub NULL, jeśli dziennik nie zawiera
+ *                      żadnej gry,
+ * @param[out] line   – numer ostatniej linii wejścia zapisanej w dzienniku
+ *                      lub 0.
+ * @return Wartość @p true, jeśli dziennik otwarto, a @p false, gdy nie
+ * udało się go otworzyć, ma niepoprawny znacznik, zapisany ruch jest
+ * niedozwolony lub nie udało się zaalokować pamięci.
+ */
+bool wal_recover(gamma_t **g, uint64_t *line);
+
+/** @brief Odtwarza grę z dziennika zapisanego w strumieniu.
+ * Czyta rekordy od bieżącej pozycji (za znacznikiem) i wykonuje ruchy
+ * z kolejnych zamkniętych grup na nowej grze bez limitu obszarów,
+ * a na koniec ustawia zapisany limit (@ref gamma_restore).
+ * @param[in] in      – strumień,
+ * @param[out] g      – odtworzona gra lub NULL, jeśli dziennik nie zawiera
+ *                      żadnej gry,
+ * @param[out] line   – numer ostatniej linii wejścia zapisanej w dzienniku
+ *                      lub 0,
+ * @param[out] length – pozycja w strumieniu za ostatnią zamkniętą grupą.
+ * @return Wartość @p true, jeśli odtworzono grę, a @p false, gdy zapisany
+ * ruch jest niedozwolony, dziennik zawiera więcej niż jedną grę lub nie
+ * udało się zaalokować pamięci.
+ */
+bool wal_read(FILE *in, gamma_t **g, uint64_t *line, uint64_t *length);
+
+/** @brief Podaje strumień, do którego należy wypisywać wyniki poleceń.
+ * Jeśli dziennik jest zapisywany, wyniki czekają w pamięci na utrwalenie
+ * bieżącej grupy rekordów; gdy uzbiera się ich @ref WAL_BUFFER bajtów,
+ * grupa jest utrwalana, a jeśli to się nie powiedzie, program kończy się
+ * z kodem 1.
+ * @return Strumień wyników lub stdout, jeśli dziennik nie jest zapisywany.
+ */
+FILE *wal_output(void);
+
+/** @brief Utrwala bieżącą grupę rekordów i wypisuje czekające wyniki.
+ * Należy ją wywołać, zanim program zablokuje się w oczekiwaniu na wejście.
+ * @return Wartość @p true, jeśli utrwalenie się powiodło lub dziennik nie
+ * jest zapisywany, a @p false w przeciwnym razie – dziennik jest wtedy
+ * zamykany, a czekające wyniki porzucane.
+ */
+bool wal_flush(void);
+
+/** @brief Podaje, jak długo można czekać na wejście bez wywołania
+ * @ref wal_flush.
+ * @return Liczba milisekund do chwili, w której grupa powinna zostać
+ * utrwalona (czas podany w @ref wal_start), 0, jeśli trzeba to zrobić
+ * od razu, lub -1, jeśli nic nie czeka na utrwalenie.
+ */
+int wal_timeout(void);
+
+/** @brief Zapisuje w dzienniku parametry nowej gry i utrwala je.
+ * Nic nie robi, jeśli dziennik nie jest zapisywany.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] line    – numer linii wejścia, która utworzyła grę.
+ * @return Wartość @p true, jeśli zapis się powiódł lub dziennik nie jest
+ * zapisywany, a @p false w przeciwnym razie lub gdy wcześniejszy zapis się
+ * nie powiódł – dziennik jest wtedy zamykany.
+ */
+bool wal_game(gamma_t *g, uint64_t line);
+
+/** @brief Zapisuje w dzienniku wykonany ruch.
+ * Nic nie robi, jeśli dziennik nie jest zapisywany.
+ * @param[in] golden  – czy ruch był złotym ruchem,
+ * @param[in] player  – numer gracza,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza,
+ * @param[in] line    – numer linii wejścia z ruchem.
+ * @return Wartość @p true, jeśli zapis się powiódł lub dziennik nie jest
+ * zapisywany, a @p false w przeciwnym razie lub gdy wcześniejszy zapis się
+ * nie powiódł – dziennik jest wtedy zamykany.
+ */
+bool wal_move(bool golden, uint32_t player, uint32_t x, uint32_t y,
+              uint64_t line);
+
+/** @brief Zamyka ostatnią grupę rekordów, utrwala dziennik, wypisuje
+ * czekające wyniki i zamyka plik.
+ * Nic nie robi, jeśli dziennik nie jest zapisywany.
+ */
+void wal_close(void);
+
+#endif /* WAL_H */